@@ -43,6 +43,22 @@ IMGUI_IMPL_API void     ImGui_ImplOpenGL3_DestroyDeviceObjects();
 // (Advanced) Use e.g. if you need to precisely control the timing of texture updates (e.g. for staged rendering), by setting ImDrawData::Textures = NULL to handle this manually.
 IMGUI_IMPL_API void     ImGui_ImplOpenGL3_UpdateTexture(ImTextureData* tex);
 
+// (Optional) Streaming upload: instead of one glBufferData() per draw list, copy the whole frame into one segment of a vertex/index ring
+// guarded by fences. Needs desktop GL 3.2+. With get_proc_address (e.g. glfwGetProcAddress) and GL 4.4 or ARB_buffer_storage the ring
+// is persistently mapped; otherwise each segment is mapped unsynchronized and the buffer is orphaned instead of waiting on the GPU.
+// Returns false when streaming is not available, in which case the default path stays in use.
+struct ImGui_ImplOpenGL3_UploadStats
+{
+    double  CpuMs = 0.0;        // CPU time spent handing vertex/index data to GL in the last RenderDrawData() call
+    size_t  Bytes = 0;          // Vertex and index bytes uploaded
+    int     Waits = 0;          // Persistent ring: times the CPU had to wait for the GPU to release a segment
+    int     Orphans = 0;        // Mapped ring: times the buffers were orphaned instead of waiting
+    bool    Streaming = false;
+    bool    Persistent = false;
+};
+IMGUI_IMPL_API bool     ImGui_ImplOpenGL3_SetStreamingUpload(bool enable, void* (*get_proc_address)(const char* name) = nullptr);
+IMGUI_IMPL_API ImGui_ImplOpenGL3_UploadStats ImGui_ImplOpenGL3_GetUploadStats();
+
 // Configuration flags to add in your imconfig file:
 //#define IMGUI_IMPL_OPENGL_ES2     // Enable ES 2 (Auto-detected on Emscripten)
 //#define IMGUI_IMPL_OPENGL_ES3     // Enable ES 3 (Auto-detected on iOS/Android)
@@ -0,0 +1,27 @@
+// alloc_stats.cpp
+// Replacement global operator new/delete that count allocations for
+// AllocStats. The standard array and nothrow forms forward to these, so they
+// are all counted. Sized delete is replaced as well, since the library's own
+// need not reach ours. C allocations (GLFW, the C runtime) are not counted.
+#include "alloc_stats.h"
+#include <cstdlib>
+#include <new>
+
+void *operator new(size_t size)
+{
+    AllocStats::allocations.fetch_add(1, memory_order_relaxed);
+    AllocStats::bytes.fetch_add(size, memory_order_relaxed);
+    if (void *p = malloc(size ? size : 1))
+        return p;
+    throw bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
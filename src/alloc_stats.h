@@ -0,0 +1,17 @@
+// alloc_stats.h
+// Process-wide count of C++ heap allocations. The counters are bumped by the
+// replacement operator new in alloc_stats.cpp; without that file linked in
+// they stay at zero.
+#pragma once
+#include <atomic>
+#include <cstdint>
+using namespace std;
+
+class AllocStats
+{
+public:
+    static inline atomic<uint64_t> allocations{0}; // operator new calls
+    static inline atomic<uint64_t> bytes{0};       // bytes requested by them
+
+    static uint64_t count() { return allocations.load(memory_order_relaxed); }
+};
@@ -0,0 +1,296 @@
+// bench.cpp
+// Headless StudentManager benchmarks on synthetic rosters (no GLFW/OpenGL).
+//
+//   bench [--rows 1000,100000,1000000] [--seed 42] [--min-iters 3]
+//         [--max-seconds 2] [--ops generate,load,save,search,query,sort,delete]
+//         [--json results.json] [--tmp bench_roster.txt]
+//
+// Every operation reports throughput, latency percentiles and the peak RSS
+// of the process so far. --json writes the same numbers for comparing runs.
+#include "student_manager.h"
+#include "roster_generator.h"
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <cstdio>
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+using namespace std;
+
+// ------------------------- Measurement -------------------------
+static long peakRssKb()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return 0;
+    return (long)(pmc.PeakWorkingSetSize / 1024);
+#else
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+#ifdef __APPLE__
+    return ru.ru_maxrss / 1024; // bytes on macOS
+#else
+    return ru.ru_maxrss;
+#endif
+#endif
+}
+
+class BenchResult
+{
+public:
+    string op;
+    size_t rows = 0;
+    size_t iterations = 0;
+    double totalSeconds = 0;
+    double throughput = 0; // units per second
+    string unit;
+    double p50Ms = 0, p90Ms = 0, p99Ms = 0, maxMs = 0;
+    long peakRssKb = 0;
+};
+
+class BenchConfig
+{
+public:
+    vector<size_t> rows = {1000, 100000, 1000000};
+    uint64_t seed = 42;
+    size_t minIterations = 3;
+    size_t maxIterations = 1000;
+    double maxSeconds = 2.0;
+    vector<string> ops = {"generate", "load", "save", "search", "query", "sort", "delete"};
+    string jsonPath;
+    string tmpPath = "bench_roster.txt";
+
+    bool wants(const string &op) const { return find(ops.begin(), ops.end(), op) != ops.end(); }
+};
+
+static double percentile(const vector<double> &sorted, double p)
+{
+    if (sorted.empty())
+        return 0;
+    size_t rank = (size_t)ceil(p * sorted.size());
+    return sorted[rank == 0 ? 0 : rank - 1];
+}
+
+// Run body until it has done minIterations and either maxSeconds elapsed or
+// maxIterations was reached. body returns how many `unit`s one call handled;
+// setup runs before each call, off the clock.
+template <typename F, typename S>
+static BenchResult measure(const BenchConfig &cfg, const string &op, size_t rows, const string &unit, F body, S setup)
+{
+    using clock = chrono::steady_clock;
+    vector<double> latencies;
+    double units = 0, total = 0;
+    while (latencies.size() < cfg.minIterations ||
+           (total < cfg.maxSeconds && latencies.size() < cfg.maxIterations))
+    {
+        setup();
+        auto t0 = clock::now();
+        units += body();
+        double sec = chrono::duration<double>(clock::now() - t0).count();
+        latencies.push_back(sec * 1000.0);
+        total += sec;
+    }
+    sort(latencies.begin(), latencies.end());
+
+    BenchResult r;
+    r.op = op;
+    r.rows = rows;
+    r.iterations = latencies.size();
+    r.totalSeconds = total;
+    r.throughput = total > 0 ? units / total : 0;
+    r.unit = unit;
+    r.p50Ms = percentile(latencies, 0.50);
+    r.p90Ms = percentile(latencies, 0.90);
+    r.p99Ms = percentile(latencies, 0.99);
+    r.maxMs = latencies.back();
+    r.peakRssKb = peakRssKb();
+    return r;
+}
+
+template <typename F>
+static BenchResult measure(const BenchConfig &cfg, const string &op, size_t rows, const string &unit, F body)
+{
+    return measure(cfg, op, rows, unit, body, [] {});
+}
+
+// ------------------------- Output -------------------------
+static void printResult(const BenchResult &r)
+{
+    printf("%-8s %10zu rows %6zu iters %14.0f %-6s p50 %9.3f  p90 %9.3f  p99 %9.3f  max %9.3f ms  rss %8ld KB\n",
+           r.op.c_str(), r.rows, r.iterations, r.throughput, r.unit.c_str(), r.p50Ms, r.p90Ms, r.p99Ms, r.maxMs, r.peakRssKb);
+    fflush(stdout);
+}
+
+static void writeJson(const BenchConfig &cfg, const vector<BenchResult> &results)
+{
+    ofstream f(cfg.jsonPath);
+    f << "{\n  \"benchmark\": \"student_manager\",\n  \"seed\": " << cfg.seed << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const BenchResult &r = results[i];
+        f << "    {\"op\": \"" << r.op << "\", \"rows\": " << r.rows << ", \"iterations\": " << r.iterations
+          << ", \"total_seconds\": " << r.totalSeconds << ", \"throughput\": " << r.throughput
+          << ", \"unit\": \"" << r.unit << "\", \"p50_ms\": " << r.p50Ms << ", \"p90_ms\": " << r.p90Ms
+          << ", \"p99_ms\": " << r.p99Ms << ", \"max_ms\": " << r.maxMs << ", \"peak_rss_kb\": " << r.peakRssKb << "}"
+          << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    f << "  ]\n}\n";
+}
+
+// ------------------------- Benchmarks -------------------------
+static void benchRoster(const BenchConfig &cfg, size_t rows, vector<BenchResult> &results)
+{
+    auto record = [&](const BenchResult &r)
+    {
+        printResult(r);
+        results.push_back(r);
+    };
+
+    StudentManager manager;
+    RosterGenerator gen(cfg.seed);
+    // Every other operation needs the roster, so it is generated regardless
+    if (cfg.wants("generate"))
+        record(measure(cfg, "generate", rows, "rows/s", [&]()
+                       {
+                           gen = RosterGenerator(cfg.seed);
+                           manager.assign(gen.generate(rows));
+                           return (double)rows; }));
+    else
+        manager.assign(gen.generate(rows));
+
+    // save before load so there is a file to read
+    if (cfg.wants("save") || cfg.wants("load"))
+        record(measure(cfg, "save", rows, "rows/s", [&]()
+                       {
+                           manager.save(cfg.tmpPath);
+                           return (double)rows; }));
+    if (cfg.wants("load"))
+        record(measure(cfg, "load", rows, "rows/s", [&]()
+                       {
+                           manager.load(cfg.tmpPath);
+                           return (double)manager.students.size(); }));
+
+    if (cfg.wants("search"))
+    {
+        static const char *terms[] = {"rah", "karim", "ayesha k", "10", "zzz"};
+        size_t i = 0;
+        record(measure(cfg, "search", rows, "rows/s", [&]()
+                       {
+                           manager.search(terms[i++ % 5]);
+                           return (double)manager.students.size(); }));
+    }
+
+    if (cfg.wants("query"))
+    {
+        static const char *queries[] = {
+            "dept:CSE cgpa>=3.5",
+            "dept:EEE grade:A* name~rahman",
+            "(dept:BBA | dept:Law) cgpa<2.5",
+            "grade:B* -dept:CSE roll>5000",
+            "name~hossain cgpa>=3.9"};
+        size_t i = 0;
+        record(measure(cfg, "query", rows, "rows/s", [&]()
+                       {
+                           manager.query(queries[i++ % 5]);
+                           return (double)manager.students.size(); }));
+    }
+
+    if (cfg.wants("sort"))
+    {
+        static const SortColumn columns[] = {SortColumn::ROLL, SortColumn::NAME, SortColumn::DEPARTMENT, SortColumn::CGPA};
+        size_t i = 0;
+        record(measure(cfg, "sort", rows, "rows/s", [&]()
+                       {
+                           manager.sortBy(columns[i++ % 4]);
+                           return (double)manager.students.size(); }));
+    }
+
+    if (cfg.wants("delete"))
+    {
+        // Rolls are 1000.. in generation order; walk them with a stride so
+        // deletes hit different parts of the roster. The full roster is put
+        // back after every 1% of it is deleted, so each delete runs on
+        // nearly `rows` rows however many iterations there are.
+        vector<Student> full = manager.students;
+        size_t batch = max<size_t>(1, rows / 100), i = 0;
+        record(measure(cfg, "delete", rows, "ops/s", [&]()
+                       {
+                           manager.removeByRoll(1000 + (int)((i++ * 7919) % rows));
+                           return 1.0; },
+                       [&]()
+                       {
+                           if (i % batch == 0 && manager.students.size() < rows)
+                               manager.assign(full);
+                       }));
+    }
+}
+
+// ------------------------- Main -------------------------
+static vector<string> splitList(const string &s)
+{
+    vector<string> out;
+    stringstream ss(s);
+    string item;
+    while (getline(ss, item, ','))
+        if (!item.empty())
+            out.push_back(item);
+    return out;
+}
+
+int main(int argc, char **argv)
+{
+    BenchConfig cfg;
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            string arg = argv[i];
+            string value = i + 1 < argc ? argv[i + 1] : "";
+            if (arg == "--rows")
+            {
+                cfg.rows.clear();
+                for (auto &r : splitList(value))
+                    cfg.rows.push_back((size_t)stoull(r));
+                ++i;
+            }
+            else if (arg == "--seed")
+                cfg.seed = stoull(value), ++i;
+            else if (arg == "--min-iters")
+                cfg.minIterations = (size_t)stoull(value), ++i;
+            else if (arg == "--max-seconds")
+                cfg.maxSeconds = stod(value), ++i;
+            else if (arg == "--ops")
+                cfg.ops = splitList(value), ++i;
+            else if (arg == "--json")
+                cfg.jsonPath = value, ++i;
+            else if (arg == "--tmp")
+                cfg.tmpPath = value, ++i;
+            else
+            {
+                cerr << "Unknown option " << arg << "\n"
+                     << "Usage: bench [--rows 1000,100000] [--seed N] [--min-iters N] [--max-seconds S]\n"
+                     << "             [--ops generate,load,save,search,query,sort,delete] [--json out.json] [--tmp file]\n";
+                return 2;
+            }
+        }
+    }
+    catch (...)
+    {
+        cerr << "Bad option value\n";
+        return 2;
+    }
+
+    vector<BenchResult> results;
+    for (size_t rows : cfg.rows)
+        benchRoster(cfg, rows, results);
+    remove(cfg.tmpPath.c_str());
+
+    if (!cfg.jsonPath.empty())
+        writeJson(cfg, results);
+    return 0;
+}
@@ -0,0 +1,324 @@
+// font_atlas_cache.h
+// On-disk cache of the glyphs ImGui has baked into its font atlas, so the next
+// launch copies them into the texture instead of rasterizing them again with
+// stb_truetype.
+//
+// ImGui 1.92 bakes glyphs on demand (one ImFontBaked per font size and
+// rasterizer density), so there is no single atlas image to save. save() walks
+// every baked size at exit and writes its glyph table plus each glyph's
+// pixels; load() re-creates those sizes, packs the rectangles again and copies
+// the pixels in. Glyphs nobody used last time are still baked lazily.
+//
+// The file is keyed by a hash of everything that changes the output: the
+// ImGui version, the font loader, the atlas texture format and padding, and
+// for every font source its TTF bytes, size, glyph ranges and rasterizer
+// settings. A cache with another key is ignored and rewritten on exit.
+//
+// File format (native endianness, it never leaves the machine):
+//   char[8]  magic "RFONTC01"
+//   u64      key
+//   u32      texture format, u32 bytes per pixel, u32 baked count
+//   per baked:  u32 font index, f32 size, f32 density, u32 glyph count
+//     per glyph:  ImFontGlyph, u16 w, u16 h, then w * h pixels: one alpha
+//                 byte each, or bpp bytes for a Colored glyph
+#pragma once
+#include "imgui.h"
+#include "imgui_internal.h"
+#include "trace.h"
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+using namespace std;
+
+static constexpr char FONT_CACHE_MAGIC[8] = {'R', 'F', 'O', 'N', 'T', 'C', '0', '1'};
+
+class FontAtlasCache
+{
+public:
+    string path = "roster_imgui.fontcache";
+    string error;
+    int restoredSizes = 0;  // baked sizes load() brought back
+    int restoredGlyphs = 0; // glyphs it copied instead of rasterizing
+
+    // Restore glyphs into `atlas`. Call after every font has been added and
+    // before the first NewFrame. Returns false on a miss (no file, other key,
+    // damaged file); the atlas is then untouched and bakes as usual.
+    bool load(ImFontAtlas *atlas)
+    {
+        TRACE_SPAN("fontCacheLoad");
+        restoredSizes = restoredGlyphs = 0;
+        vector<unsigned char> data;
+        if (!readFile(data))
+            return fail("no font cache at " + path);
+
+        Reader r{data.data(), data.data() + data.size()};
+        char magic[8];
+        uint64_t fileKey = 0;
+        uint32_t format = 0, bpp = 0, bakedCount = 0;
+        if (!r.get(magic, 8) || memcmp(magic, FONT_CACHE_MAGIC, 8) != 0 || !r.get(&fileKey) || !r.get(&format) ||
+            !r.get(&bpp) || !r.get(&bakedCount))
+            return fail(path + " is not a font cache");
+        if (fileKey != key(atlas) || format != (uint32_t)atlas->TexData->Format ||
+            bpp != (uint32_t)atlas->TexData->BytesPerPixel)
+            return fail(path + " was built for other fonts");
+
+        // Validate the whole file first so a damaged one restores nothing
+        Reader check = r;
+        for (uint32_t b = 0; b < bakedCount; ++b)
+        {
+            uint32_t font = 0, glyphs = 0;
+            float size = 0, density = 0;
+            if (!check.get(&font) || !check.get(&size) || !check.get(&density) || !check.get(&glyphs) ||
+                font >= (uint32_t)atlas->Fonts.Size || !(size > 0.0f) || !(density > 0.0f))
+                return fail(path + " is damaged");
+            for (uint32_t g = 0; g < glyphs; ++g)
+            {
+                ImFontGlyph glyph;
+                uint16_t w = 0, h = 0;
+                if (!check.get(&glyph) || !check.get(&w) || !check.get(&h) ||
+                    !check.skip((size_t)w * h * pixelSize(glyph, bpp)))
+                    return fail(path + " is damaged");
+            }
+        }
+
+        for (uint32_t b = 0; b < bakedCount; ++b)
+        {
+            uint32_t font = 0, glyphs = 0;
+            float size = 0, density = 0;
+            r.get(&font);
+            r.get(&size);
+            r.get(&density);
+            r.get(&glyphs);
+            ImFontBaked *baked = ImFontAtlasBakedGetOrAdd(atlas, atlas->Fonts[font], size, density);
+            ++restoredSizes;
+            for (uint32_t g = 0; g < glyphs; ++g)
+            {
+                ImFontGlyph glyph;
+                uint16_t w = 0, h = 0;
+                r.get(&glyph);
+                r.get(&w);
+                r.get(&h);
+                const unsigned char *pixels = r.p;
+                r.skip((size_t)w * h * pixelSize(glyph, bpp));
+                // Creating the size already loaded space and tab
+                if (baked->IsGlyphLoaded((ImWchar)glyph.Codepoint))
+                    continue;
+                restoreGlyph(atlas, baked, glyph, w, h, pixels);
+            }
+        }
+        error.clear();
+        return true;
+    }
+
+    // Write every glyph baked so far. Call before the ImGui context is destroyed.
+    bool save(ImFontAtlas *atlas)
+    {
+        TRACE_SPAN("fontCacheSave");
+        ImFontAtlasBuilder *builder = atlas->Builder;
+        ImTextureData *tex = atlas->TexData;
+        if (!builder || !tex || !tex->Pixels)
+            return fail("font atlas has not been built");
+
+        vector<unsigned char> out;
+        uint64_t fileKey = key(atlas);
+        uint32_t format = (uint32_t)tex->Format, bpp = (uint32_t)tex->BytesPerPixel, bakedCount = 0;
+        put(out, FONT_CACHE_MAGIC, 8);
+        put(out, &fileKey);
+        put(out, &format);
+        put(out, &bpp);
+        size_t countAt = out.size();
+        put(out, &bakedCount);
+
+        for (int b = 0; b < builder->BakedPool.Size; ++b)
+        {
+            ImFontBaked *baked = &builder->BakedPool[b];
+            int font = atlas->Fonts.find_index(baked->ContainerFont);
+            if (baked->WantDestroy || font < 0)
+                continue;
+            uint32_t fontIndex = (uint32_t)font, glyphs = 0;
+            put(out, &fontIndex);
+            put(out, &baked->Size);
+            put(out, &baked->RasterizerDensity);
+            size_t glyphsAt = out.size();
+            put(out, &glyphs);
+            for (const ImFontGlyph &g : baked->Glyphs)
+            {
+                // Codepoint 0 is the stand-in fallback; it is recreated on demand
+                if (g.Codepoint == 0)
+                    continue;
+                ImTextureRect *rect = g.PackId != ImFontAtlasRectId_Invalid ? ImFontAtlasPackGetRectSafe(atlas, g.PackId) : nullptr;
+                uint16_t w = rect ? rect->w : 0, h = rect ? rect->h : 0;
+                put(out, &g);
+                put(out, &w);
+                put(out, &h);
+                if (rect)
+                {
+                    ImTextureFormat storedFormat = g.Colored ? tex->Format : ImTextureFormat_Alpha8;
+                    size_t at = out.size();
+                    out.resize(at + (size_t)w * h * pixelSize(g, bpp));
+                    ImFontAtlasTextureBlockConvert((const unsigned char *)tex->GetPixelsAt(rect->x, rect->y), tex->Format,
+                                                   tex->GetPitch(), out.data() + at, storedFormat,
+                                                   w * (int)pixelSize(g, bpp), w, h);
+                }
+                ++glyphs;
+            }
+            memcpy(out.data() + glyphsAt, &glyphs, sizeof(glyphs));
+            ++bakedCount;
+        }
+        memcpy(out.data() + countAt, &bakedCount, sizeof(bakedCount));
+
+        // Write beside the old cache and swap, so a crash never leaves half a file
+        string tmp = path + ".tmp";
+        FILE *f = fopen(tmp.c_str(), "wb");
+        if (!f)
+            return fail("cannot write " + tmp);
+        bool written = fwrite(out.data(), 1, out.size(), f) == out.size();
+        written = fclose(f) == 0 && written;
+        remove(path.c_str());
+        if (!written || rename(tmp.c_str(), path.c_str()) != 0)
+        {
+            remove(tmp.c_str());
+            return fail("cannot write " + path);
+        }
+        return true;
+    }
+
+    // FNV-1a over every input that affects the baked glyphs
+    static uint64_t key(const ImFontAtlas *atlas)
+    {
+        uint64_t h = 1469598103934665603ULL;
+        auto mix = [&h](const void *data, size_t n)
+        {
+            const unsigned char *p = (const unsigned char *)data;
+            for (size_t i = 0; i < n; ++i)
+                h = (h ^ p[i]) * 1099511628211ULL;
+        };
+        auto mixValue = [&mix](auto v) { mix(&v, sizeof(v)); };
+
+        mixValue(IMGUI_VERSION_NUM);
+        mixValue(sizeof(ImFontGlyph));
+        mix(atlas->FontLoaderName, atlas->FontLoaderName ? strlen(atlas->FontLoaderName) : 0);
+        mixValue(atlas->FontLoaderFlags);
+        mixValue(atlas->Flags);
+        mixValue(atlas->TexDesiredFormat);
+        mixValue(atlas->TexGlyphPadding);
+        mixValue(atlas->Fonts.Size);
+        for (const ImFontConfig &src : atlas->Sources)
+        {
+            mixValue(src.FontDataSize);
+            mix(src.FontData, (size_t)src.FontDataSize);
+            mixValue(src.FontNo);
+            mixValue(src.SizePixels);
+            mixValue(src.MergeMode);
+            mixValue(src.PixelSnapH);
+            mixValue(src.PixelSnapV);
+            mixValue(src.OversampleH);
+            mixValue(src.OversampleV);
+            mixValue(src.GlyphOffset.x);
+            mixValue(src.GlyphOffset.y);
+            mixValue(src.GlyphMinAdvanceX);
+            mixValue(src.GlyphMaxAdvanceX);
+            mixValue(src.GlyphExtraAdvanceX);
+            mixValue(src.RasterizerMultiply);
+            mixValue(src.RasterizerDensity);
+            mixValue(src.FontLoaderFlags);
+            mixValue(src.EllipsisChar);
+            for (const ImWchar *range = src.GlyphRanges; range && *range; ++range)
+                mixValue(*range);
+            mixValue(0);
+            for (const ImWchar *range = src.GlyphExcludeRanges; range && *range; ++range)
+                mixValue(*range);
+            mixValue(0);
+        }
+        return h;
+    }
+
+private:
+    // Bounds-checked cursor over the file
+    class Reader
+    {
+    public:
+        const unsigned char *p;
+        const unsigned char *end;
+
+        bool skip(size_t n)
+        {
+            if ((size_t)(end - p) < n)
+                return false;
+            p += n;
+            return true;
+        }
+
+        bool get(void *dst, size_t n)
+        {
+            if ((size_t)(end - p) < n)
+                return false;
+            memcpy(dst, p, n);
+            p += n;
+            return true;
+        }
+
+        template <typename T>
+        bool get(T *dst) { return get(dst, sizeof(T)); }
+    };
+
+    bool fail(const string &message)
+    {
+        error = message;
+        return false;
+    }
+
+    bool readFile(vector<unsigned char> &data)
+    {
+        FILE *f = fopen(path.c_str(), "rb");
+        if (!f)
+            return false;
+        unsigned char chunk[65536];
+        size_t got;
+        while ((got = fread(chunk, 1, sizeof(chunk), f)) > 0)
+            data.insert(data.end(), chunk, chunk + got);
+        fclose(f);
+        return true;
+    }
+
+    static void put(vector<unsigned char> &out, const void *data, size_t n)
+    {
+        const unsigned char *p = (const unsigned char *)data;
+        out.insert(out.end(), p, p + n);
+    }
+
+    template <typename T>
+    static void put(vector<unsigned char> &out, const T *value) { put(out, value, sizeof(T)); }
+
+    // Font glyphs only carry coverage, so they are stored as alpha; colored
+    // ones keep the texture's format
+    static size_t pixelSize(const ImFontGlyph &glyph, uint32_t bpp) { return glyph.Colored ? bpp : 1; }
+
+    // Pack a fresh rectangle for the glyph and copy its cached pixels in. The
+    // glyph's metrics were stored after clamping and snapping, so it is added
+    // without a source to keep them as they are; the pixels were stored after
+    // post-processing, so they are copied rather than set as a new bitmap.
+    void restoreGlyph(ImFontAtlas *atlas, ImFontBaked *baked, ImFontGlyph glyph, int w, int h,
+                      const unsigned char *pixels)
+    {
+        glyph.U0 = glyph.V0 = glyph.U1 = glyph.V1 = 0.0f;
+        glyph.PackId = ImFontAtlasRectId_Invalid;
+        if (w > 0 && h > 0)
+        {
+            ImFontAtlasRectId id = ImFontAtlasPackAddRect(atlas, w, h);
+            if (id == ImFontAtlasRectId_Invalid)
+                return; // out of texture space; it will be baked when used
+            ImTextureRect *r = ImFontAtlasPackGetRect(atlas, id);
+            ImTextureData *tex = atlas->TexData; // packing may have grown it
+            ImTextureFormat storedFormat = glyph.Colored ? tex->Format : ImTextureFormat_Alpha8;
+            ImFontAtlasTextureBlockConvert(pixels, storedFormat, w * (int)pixelSize(glyph, tex->BytesPerPixel),
+                                           (unsigned char *)tex->GetPixelsAt(r->x, r->y), tex->Format, tex->GetPitch(), w, h);
+            ImFontAtlasTextureBlockQueueUpload(atlas, tex, r->x, r->y, r->w, r->h);
+            glyph.PackId = id;
+        }
+        ImFontAtlasBakedAddFontGlyph(atlas, baked, nullptr, &glyph);
+        ++restoredGlyphs;
+    }
+};
@@ -0,0 +1,70 @@
+// frame_arena.h
+// Fixed scratch space for text formatted during a frame. reset() at the start
+// of every frame makes the whole buffer available again, so row labels and
+// headers are built without touching the heap. Both front-ends use it; the
+// counters let them show how much scratch each frame took.
+#pragma once
+#include <cstdarg>
+#include <cstdio>
+#include <cstddef>
+#include <cstdint>
+using namespace std;
+
+class FrameArena
+{
+public:
+    static constexpr size_t CAPACITY = 64 * 1024;
+
+    size_t used = 0;
+    size_t highWater = 0;     // most bytes used by any frame so far
+    uint32_t allocations = 0; // format/alloc calls this frame
+
+    // The frame before the last reset()
+    size_t lastUsed = 0;
+    uint32_t lastAllocations = 0;
+
+    void reset()
+    {
+        lastUsed = used;
+        lastAllocations = allocations;
+        used = 0;
+        allocations = 0;
+    }
+
+    // Uninitialised scratch memory until the next reset(), or null when the
+    // arena cannot fit it
+    void *alloc(size_t size, size_t align = alignof(max_align_t))
+    {
+        size_t start = (used + align - 1) & ~(align - 1);
+        if (start > CAPACITY || size > CAPACITY - start)
+            return nullptr;
+        ++allocations;
+        used = start + size;
+        if (used > highWater)
+            highWater = used;
+        return buffer + start;
+    }
+
+    // printf into the arena; the result lives until the next reset(). When the
+    // arena is full the text is truncated rather than allocated elsewhere.
+    const char *format(const char *fmt, ...)
+    {
+        char *out = buffer + used;
+        size_t room = CAPACITY - used;
+        if (room == 0)
+            return "";
+        ++allocations;
+        va_list args;
+        va_start(args, fmt);
+        int n = vsnprintf(out, room, fmt, args);
+        va_end(args);
+        size_t written = n < 0 ? 0 : ((size_t)n < room ? (size_t)n : room - 1);
+        used += written + 1;
+        if (used > highWater)
+            highWater = used;
+        return out;
+    }
+
+private:
+    alignas(max_align_t) char buffer[CAPACITY];
+};
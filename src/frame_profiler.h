@@ -0,0 +1,168 @@
+// frame_profiler.h
+// Per-phase frame timings kept in a ring buffer for the F3 overlay
+#pragma once
+#include <chrono>
+#include <algorithm>
+#include "trace.h"
+#include "alloc_stats.h"
+using namespace std;
+
+enum class FramePhase
+{
+    INPUT,   // glfwPollEvents and click/keyboard handling
+    QUERY,   // running the search and building `visible`
+    DRAW,    // all UI drawing, including text
+    TEXT,    // time inside drawText (part of DRAW)
+    SWAP,    // glfwSwapBuffers
+    FRAME,   // whole loop iteration
+    COUNT
+};
+
+class FrameProfiler
+{
+public:
+    static constexpr int HISTORY = 300;
+    static constexpr int PHASES = (int)FramePhase::COUNT;
+
+    // Off by default; while off, scopes skip the clock entirely
+    bool enabled = false;
+
+    // Milliseconds per phase for the last HISTORY frames
+    float samples[HISTORY][PHASES] = {};
+    uint32_t allocations[HISTORY] = {}; // operator new calls per frame
+
+    // Input-to-swap latency of the last HISTORY frames that consumed input
+    float inputLatency[HISTORY] = {};
+    int latencyHead = 0;
+    int latencyCount = 0;
+    int head = 0;  // slot the next finished frame goes into
+    int count = 0; // number of valid frames
+
+    static const char *phaseName(int phase)
+    {
+        static const char *names[PHASES] = {"input", "query", "draw", "text", "swap", "frame"};
+        return names[phase];
+    }
+
+    // Turning the profiler on starts a fresh history
+    void setEnabled(bool on)
+    {
+        if (on && !enabled)
+            head = count = latencyHead = latencyCount = 0;
+        enabled = on;
+    }
+
+    void beginFrame()
+    {
+        frameActive = enabled;
+        if (!frameActive)
+            return;
+        fill(current, current + PHASES, 0.0f);
+        frameAllocStart = AllocStats::count();
+        frameStart = chrono::steady_clock::now();
+    }
+
+    // Frames toggled on or off midway are dropped
+    void endFrame()
+    {
+        if (!enabled || !frameActive)
+            return;
+        current[(int)FramePhase::FRAME] = msSince(frameStart);
+        copy(current, current + PHASES, samples[head]);
+        allocations[head] = (uint32_t)(AllocStats::count() - frameAllocStart);
+        head = (head + 1) % HISTORY;
+        count = min(count + 1, HISTORY);
+    }
+
+    void add(FramePhase phase, float ms) { current[(int)phase] += ms; }
+
+    // Milliseconds from the frame's first input event until its swap finished
+    void addInputLatency(float ms)
+    {
+        if (!enabled)
+            return;
+        inputLatency[latencyHead] = ms;
+        latencyHead = (latencyHead + 1) % HISTORY;
+        latencyCount = min(latencyCount + 1, HISTORY);
+    }
+
+    // Frame i frames ago (0 = most recent)
+    const float *frame(int ago) const { return samples[(head - 1 - ago + 2 * HISTORY) % HISTORY]; }
+    uint32_t frameAllocations(int ago) const { return allocations[(head - 1 - ago + 2 * HISTORY) % HISTORY]; }
+
+    // Nearest-rank percentiles of one phase over the recorded frames
+    void percentiles(int phase, float &p50, float &p95, float &p99) const
+    {
+        float values[HISTORY];
+        for (int i = 0; i < count; ++i)
+            values[i] = frame(i)[phase];
+        nearestRank(values, count, p50, p95, p99);
+    }
+
+    void latencyPercentiles(float &p50, float &p95, float &p99) const
+    {
+        float values[HISTORY];
+        copy(inputLatency, inputLatency + latencyCount, values);
+        nearestRank(values, latencyCount, p50, p95, p99);
+    }
+
+    static float msSince(chrono::steady_clock::time_point t0)
+    {
+        return chrono::duration<float, milli>(chrono::steady_clock::now() - t0).count();
+    }
+
+private:
+    // Sorts values in place
+    static void nearestRank(float *values, int n, float &p50, float &p95, float &p99)
+    {
+        sort(values, values + n);
+        auto at = [&](float p)
+        {
+            int rank = (int)(p * n + 0.999f);
+            return n ? values[max(0, rank - 1)] : 0.0f;
+        };
+        p50 = at(0.50f);
+        p95 = at(0.95f);
+        p99 = at(0.99f);
+    }
+
+    float current[PHASES] = {};
+    bool frameActive = false;
+    uint64_t frameAllocStart = 0;
+    chrono::steady_clock::time_point frameStart;
+};
+
+// Adds the lifetime of the scope to a phase when the profiler is enabled,
+// and records it as a trace span when tracing is on
+class ProfileScope
+{
+public:
+    ProfileScope(FrameProfiler &profiler, FramePhase phase)
+        : profiler(profiler), phase(phase), profiling(profiler.enabled), tracing(Trace::on())
+    {
+        if (profiling | tracing)
+            start = chrono::steady_clock::now();
+    }
+
+    ~ProfileScope() { stop(); }
+
+    // End the measurement before the scope closes
+    void stop()
+    {
+        if (profiling | tracing)
+        {
+            auto end = chrono::steady_clock::now();
+            if (profiling)
+                profiler.add(phase, chrono::duration<float, milli>(end - start).count());
+            if (tracing)
+                Trace::record(FrameProfiler::phaseName((int)phase), "frame", Trace::toNs(start), Trace::toNs(end));
+        }
+        profiling = tracing = false;
+    }
+
+private:
+    FrameProfiler &profiler;
+    FramePhase phase;
+    bool profiling, tracing;
+    chrono::steady_clock::time_point start;
+};
@@ -7,6 +7,7 @@
 //  [X] Renderer: User texture binding. Use 'GLuint' OpenGL texture as texture identifier. Read the FAQ about ImTextureID/ImTextureRef!
 //  [x] Renderer: Large meshes support (64k+ vertices) even with 16-bit indices (ImGuiBackendFlags_RendererHasVtxOffset) [Desktop OpenGL only!]
 //  [X] Renderer: Texture updates support for dynamic font atlas (ImGuiBackendFlags_RendererHasTextures).
+//  [x] Renderer: Optional streaming upload through a ring of fenced buffers (ImGui_ImplOpenGL3_SetStreamingUpload) [Desktop OpenGL 3.2+ only!]
 
 // About WebGL/ES:
 // - You need to '#define IMGUI_IMPL_OPENGL_ES2' or '#define IMGUI_IMPL_OPENGL_ES3' to use WebGL or OpenGL ES.
@@ -23,6 +24,9 @@
 
 // CHANGELOG
 // (minor and older changes stripped away, please see git history for details)
+//  [Roster]    OpenGL: Added ImGui_ImplOpenGL3_SetStreamingUpload(): all draw lists are copied into one segment of a vertex/index ring per frame,
+//              persistently mapped with glBufferStorage() on GL 4.4+ or ARB_buffer_storage, otherwise mapped unsynchronized and orphaned instead of
+//              stalling. Fences keep the CPU from overwriting a segment the GPU still reads. Added ImGui_ImplOpenGL3_GetUploadStats().
 //  2025-06-11: OpenGL: Added support for ImGuiBackendFlags_RendererHasTextures, for dynamic font atlas. Removed ImGui_ImplOpenGL3_CreateFontsTexture() and ImGui_ImplOpenGL3_DestroyFontsTexture().
 //  2025-06-04: OpenGL: Made GLES 3.20 contexts not access GL_CONTEXT_PROFILE_MASK nor GL_PRIMITIVE_RESTART. (#8664)
 //  2025-02-18: OpenGL: Lazily reinitialize embedded GL loader for when calling backend from e.g. other DLL boundaries. (#8406)
@@ -122,6 +126,7 @@
 #include "imgui_impl_opengl3.h"
 #include <stdio.h>
 #include <stdint.h>     // intptr_t
+#include <chrono>       // upload timing for ImGui_ImplOpenGL3_GetUploadStats()
 #if defined(__APPLE__)
 #include <TargetConditionals.h>
 #endif
@@ -172,9 +177,9 @@
 //   Typically you would run: python3 ./gl3w_gen.py --output ../imgui/backends/imgui_impl_opengl3_loader.h --ref ../imgui/backends/imgui_impl_opengl3.cpp ./extra_symbols.txt
 // - You can temporarily use an unstripped version. See https://github.com/dearimgui/gl3w_stripped/releases
 // Changes to this backend using new APIs should be accompanied by a regenerated stripped loader version.
-#define IMGL3W_IMPL
-#define IMGUI_IMPL_OPENGL_LOADER_IMGL3W
-#include "imgui_impl_opengl3_loader.h"
+// This project does not vendor imgui_impl_opengl3_loader.h: GL comes from glad (include/glad, src/glad.c),
+// so the application calls gladLoadGLLoader() before ImGui_ImplOpenGL3_Init().
+#include <glad/glad.h>
 #endif
 
 // Vertex arrays are not supported on ES2/WebGL1 unless Emscripten which uses an extension
@@ -210,6 +215,20 @@
 #define IMGUI_IMPL_OPENGL_MAY_HAVE_VTX_OFFSET
 #endif
 
+// Desktop GL 3.2+ has fences (glFenceSync) and glDrawElementsBaseVertex(), which the streaming upload path needs.
+// glBufferStorage() is GL 4.4 / ARB_buffer_storage and is fetched at runtime, so the loader does not need to provide it.
+#if defined(IMGUI_IMPL_OPENGL_MAY_HAVE_VTX_OFFSET)
+#define IMGUI_IMPL_OPENGL_MAY_HAVE_STREAMING
+#define IMGUI_IMPL_OPENGL_STREAM_SEGMENTS       3       // Frames the GPU may still be reading while the CPU writes the next one
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT                   0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT                     0x0080
+#endif
+typedef void (APIENTRYP PFN_ImGui_ImplOpenGL3_glBufferStorage)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+#endif
+
 // Desktop GL 3.3+ and GL ES 3.0+ have glBindSampler()
 #if !defined(IMGUI_IMPL_OPENGL_ES2) && (defined(IMGUI_IMPL_OPENGL_ES3) || defined(GL_VERSION_3_3))
 #define IMGUI_IMPL_OPENGL_MAY_HAVE_BIND_SAMPLER
@@ -224,6 +243,16 @@
 #define GL_CALL(_CALL)      _CALL   // Call without error check
 #endif
 
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_STREAMING
+// One ring for vertices or indices: IMGUI_IMPL_OPENGL_STREAM_SEGMENTS segments of SegmentSize bytes, one per frame
+struct ImGui_ImplOpenGL3_StreamBuffer
+{
+    GLuint          Handle;
+    GLsizeiptr      SegmentSize;
+    char*           Mapped;                  // Persistent mapping of the whole buffer, or nullptr when mapping per frame
+};
+#endif
+
 // OpenGL Data
 struct ImGui_ImplOpenGL3_Data
 {
@@ -247,6 +276,16 @@ struct ImGui_ImplOpenGL3_Data
     bool            HasClipOrigin;
     bool            UseBufferSubData;
     ImVector<char>  TempBuffer;
+    ImGui_ImplOpenGL3_UploadStats UploadStats;
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_STREAMING
+    bool            HasBufferStorage;        // GL 4.4 or GL_ARB_buffer_storage
+    bool            UseStreaming;
+    bool            StreamPersistent;
+    PFN_ImGui_ImplOpenGL3_glBufferStorage BufferStorage;
+    ImGui_ImplOpenGL3_StreamBuffer StreamVtx, StreamIdx;
+    GLsync          StreamFences[IMGUI_IMPL_OPENGL_STREAM_SEGMENTS];
+    int             StreamSegment;           // Segment written this frame
+#endif
 
     ImGui_ImplOpenGL3_Data() { memset((void*)this, 0, sizeof(*this)); }
 };
@@ -404,8 +443,16 @@ bool    ImGui_ImplOpenGL3_Init(const char* glsl_version)
         const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, i);
         if (extension != nullptr && strcmp(extension, "GL_ARB_clip_control") == 0)
             bd->HasClipOrigin = true;
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_STREAMING
+        if (extension != nullptr && strcmp(extension, "GL_ARB_buffer_storage") == 0)
+            bd->HasBufferStorage = true;
+#endif
     }
 #endif
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_STREAMING
+    if (bd->GlVersion >= 440)
+        bd->HasBufferStorage = true;
+#endif
 
     return true;
 }
@@ -499,8 +546,17 @@ static void ImGui_ImplOpenGL3_SetupRenderState(ImDrawData* draw_data, int fb_wid
 #endif
 
     // Bind vertex/index buffers and setup attributes for ImDrawVert
-    GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, bd->VboHandle));
-    GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bd->ElementsHandle));
+    GLuint vbo_handle = bd->VboHandle;
+    GLuint elements_handle = bd->ElementsHandle;
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_STREAMING
+    if (bd->UseStreaming)
+    {
+        vbo_handle = bd->StreamVtx.Handle;
+        elements_handle = bd->StreamIdx.Handle;
+    }
+#endif
+    GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, vbo_handle));
+    GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elements_handle));
     GL_CALL(glEnableVertexAttribArray(bd->AttribLocationVtxPos));
     GL_CALL(glEnableVertexAttribArray(bd->AttribLocationVtxUV));
     GL_CALL(glEnableVertexAttribArray(bd->AttribLocationVtxColor));
@@ -509,6 +565,158 @@ static void ImGui_ImplOpenGL3_SetupRenderState(ImDrawData* draw_data, int fb_wid
     GL_CALL(glVertexAttribPointer(bd->AttribLocationVtxColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ImDrawVert), (GLvoid*)offsetof(ImDrawVert, col)));
 }
 
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_STREAMING
+// Streaming buffers are created, mapped and orphaned through GL_COPY_WRITE_BUFFER, which is not part of any VAO state.
+// (glGetIntegerv(GL_COPY_WRITE_BUFFER) returns its binding; GL_COPY_WRITE_BUFFER_BINDING is the GL 4.2 alias.)
+static void ImGui_ImplOpenGL3_DestroyStreamBuffer(ImGui_ImplOpenGL3_StreamBuffer* buf)
+{
+    if (buf->Handle == 0)
+        return;
+    if (buf->Mapped != nullptr)
+    {
+        GLint last_copy_write_buffer; glGetIntegerv(GL_COPY_WRITE_BUFFER, &last_copy_write_buffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buf->Handle);
+        glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, (GLuint)last_copy_write_buffer);
+    }
+    glDeleteBuffers(1, &buf->Handle);
+    buf->Handle = 0;
+    buf->SegmentSize = 0;
+    buf->Mapped = nullptr;
+}
+
+static void ImGui_ImplOpenGL3_DeleteStreamFences(ImGui_ImplOpenGL3_Data* bd)
+{
+    for (GLsync& fence : bd->StreamFences)
+        if (fence != nullptr)
+        {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+}
+
+static void ImGui_ImplOpenGL3_DestroyStreamBuffers(ImGui_ImplOpenGL3_Data* bd)
+{
+    ImGui_ImplOpenGL3_DeleteStreamFences(bd);
+    ImGui_ImplOpenGL3_DestroyStreamBuffer(&bd->StreamVtx);
+    ImGui_ImplOpenGL3_DestroyStreamBuffer(&bd->StreamIdx);
+}
+
+static bool ImGui_ImplOpenGL3_CreateStreamBuffer(ImGui_ImplOpenGL3_Data* bd, ImGui_ImplOpenGL3_StreamBuffer* buf, GLsizeiptr segment_size)
+{
+    ImGui_ImplOpenGL3_DestroyStreamBuffer(buf);
+    const GLsizeiptr total_size = segment_size * IMGUI_IMPL_OPENGL_STREAM_SEGMENTS;
+    GLint last_copy_write_buffer; glGetIntegerv(GL_COPY_WRITE_BUFFER, &last_copy_write_buffer);
+    glGenBuffers(1, &buf->Handle);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buf->Handle);
+    if (bd->StreamPersistent)
+    {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        bd->BufferStorage(GL_COPY_WRITE_BUFFER, total_size, nullptr, flags);
+        buf->Mapped = (char*)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, total_size, flags);
+    }
+    else
+    {
+        glBufferData(GL_COPY_WRITE_BUFFER, total_size, nullptr, GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, (GLuint)last_copy_write_buffer);
+    buf->SegmentSize = segment_size;
+    return !bd->StreamPersistent || buf->Mapped != nullptr;
+}
+
+// Copy every draw list of the frame back to back into the next segment of both rings.
+// Draw calls then address the segment with an index offset and base vertex, see ImGui_ImplOpenGL3_RenderDrawData().
+static void ImGui_ImplOpenGL3_StreamUpload(ImGui_ImplOpenGL3_Data* bd, ImDrawData* draw_data)
+{
+    const GLsizeiptr vtx_size = (GLsizeiptr)draw_data->TotalVtxCount * (int)sizeof(ImDrawVert);
+    const GLsizeiptr idx_size = (GLsizeiptr)draw_data->TotalIdxCount * (int)sizeof(ImDrawIdx);
+    bd->StreamSegment = (bd->StreamSegment + 1) % IMGUI_IMPL_OPENGL_STREAM_SEGMENTS;
+    const int segment = bd->StreamSegment;
+
+    // Grow both rings with headroom. Segment sizes stay multiples of sizeof(ImDrawVert) so a segment starts on a whole vertex.
+    if (vtx_size > bd->StreamVtx.SegmentSize || idx_size > bd->StreamIdx.SegmentSize || bd->StreamVtx.Handle == 0)
+    {
+        ImGui_ImplOpenGL3_DeleteStreamFences(bd);
+        GLsizeiptr vtx_capacity = (GLsizeiptr)draw_data->TotalVtxCount + draw_data->TotalVtxCount / 2;
+        GLsizeiptr idx_capacity = (GLsizeiptr)draw_data->TotalIdxCount + draw_data->TotalIdxCount / 2;
+        if (vtx_capacity < 16384) vtx_capacity = 16384;
+        if (idx_capacity < 32768) idx_capacity = 32768;
+        bool ok = ImGui_ImplOpenGL3_CreateStreamBuffer(bd, &bd->StreamVtx, vtx_capacity * (int)sizeof(ImDrawVert)) &&
+                  ImGui_ImplOpenGL3_CreateStreamBuffer(bd, &bd->StreamIdx, idx_capacity * (int)sizeof(ImDrawIdx));
+        if (!ok && bd->StreamPersistent)
+        {
+            // Persistent mapping refused: fall back to mapping each frame
+            bd->StreamPersistent = false;
+            ImGui_ImplOpenGL3_CreateStreamBuffer(bd, &bd->StreamVtx, vtx_capacity * (int)sizeof(ImDrawVert));
+            ImGui_ImplOpenGL3_CreateStreamBuffer(bd, &bd->StreamIdx, idx_capacity * (int)sizeof(ImDrawIdx));
+        }
+    }
+
+    GLint last_copy_write_buffer; glGetIntegerv(GL_COPY_WRITE_BUFFER, &last_copy_write_buffer);
+
+    // The frame that last used this segment must be done with it
+    if (GLsync fence = bd->StreamFences[segment])
+    {
+        if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+        {
+            if (bd->StreamPersistent)
+            {
+                bd->UploadStats.Waits++;
+                while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) {}
+            }
+            else
+            {
+                // Give the driver fresh storage rather than waiting; the GPU keeps reading the old one
+                bd->UploadStats.Orphans++;
+                ImGui_ImplOpenGL3_DeleteStreamFences(bd);
+                fence = nullptr;
+                glBindBuffer(GL_COPY_WRITE_BUFFER, bd->StreamVtx.Handle);
+                glBufferData(GL_COPY_WRITE_BUFFER, bd->StreamVtx.SegmentSize * IMGUI_IMPL_OPENGL_STREAM_SEGMENTS, nullptr, GL_STREAM_DRAW);
+                glBindBuffer(GL_COPY_WRITE_BUFFER, bd->StreamIdx.Handle);
+                glBufferData(GL_COPY_WRITE_BUFFER, bd->StreamIdx.SegmentSize * IMGUI_IMPL_OPENGL_STREAM_SEGMENTS, nullptr, GL_STREAM_DRAW);
+            }
+        }
+        if (fence != nullptr)
+        {
+            glDeleteSync(fence);
+            bd->StreamFences[segment] = nullptr;
+        }
+    }
+
+    ImGui_ImplOpenGL3_StreamBuffer* bufs[2] = { &bd->StreamVtx, &bd->StreamIdx };
+    for (int b = 0; b < 2; b++)
+    {
+        ImGui_ImplOpenGL3_StreamBuffer* buf = bufs[b];
+        const GLsizeiptr size = (b == 0) ? vtx_size : idx_size;
+        if (size == 0)
+            continue;
+        char* dst = nullptr;
+        if (buf->Mapped != nullptr)
+        {
+            dst = buf->Mapped + buf->SegmentSize * segment;
+        }
+        else
+        {
+            // Unsynchronized is safe: the fence above guarantees the GPU no longer reads this range
+            glBindBuffer(GL_COPY_WRITE_BUFFER, buf->Handle);
+            dst = (char*)glMapBufferRange(GL_COPY_WRITE_BUFFER, buf->SegmentSize * segment, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        }
+        if (dst == nullptr)
+            continue;
+        for (const ImDrawList* draw_list : draw_data->CmdLists)
+        {
+            const size_t n = (b == 0) ? (size_t)draw_list->VtxBuffer.Size * sizeof(ImDrawVert) : (size_t)draw_list->IdxBuffer.Size * sizeof(ImDrawIdx);
+            memcpy(dst, (b == 0) ? (const void*)draw_list->VtxBuffer.Data : (const void*)draw_list->IdxBuffer.Data, n);
+            dst += n;
+        }
+        if (buf->Mapped == nullptr)
+            glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, (GLuint)last_copy_write_buffer);
+    bd->UploadStats.Bytes += (size_t)(vtx_size + idx_size);
+}
+#endif
+
 // OpenGL3 Render function.
 // Note that this implementation is little overcomplicated because we are saving/setting up/restoring every OpenGL state explicitly.
 // This is in order to be able to run within an OpenGL engine that doesn't do so.
@@ -576,6 +784,23 @@ void    ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data)
     GLuint vertex_array_object = 0;
 #ifdef IMGUI_IMPL_OPENGL_USE_VERTEX_ARRAY
     GL_CALL(glGenVertexArrays(1, &vertex_array_object));
+#endif
+    bd->UploadStats = ImGui_ImplOpenGL3_UploadStats();
+    std::chrono::steady_clock::duration upload_time = std::chrono::steady_clock::duration::zero();
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_STREAMING
+    // Upload everything before binding, so the render state picks up a ring that may just have grown
+    GLsizeiptr stream_vtx_base = 0;     // Segment start, in vertices and in index bytes
+    GLsizeiptr stream_idx_base = 0;
+    if (bd->UseStreaming)
+    {
+        const std::chrono::steady_clock::time_point upload_start = std::chrono::steady_clock::now();
+        ImGui_ImplOpenGL3_StreamUpload(bd, draw_data);
+        upload_time += std::chrono::steady_clock::now() - upload_start;
+        stream_vtx_base = bd->StreamVtx.SegmentSize * bd->StreamSegment / (int)sizeof(ImDrawVert);
+        stream_idx_base = bd->StreamIdx.SegmentSize * bd->StreamSegment;
+        bd->UploadStats.Streaming = true;
+        bd->UploadStats.Persistent = bd->StreamPersistent;
+    }
 #endif
     ImGui_ImplOpenGL3_SetupRenderState(draw_data, fb_width, fb_height, vertex_array_object);
 
@@ -584,6 +809,8 @@ void    ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data)
     ImVec2 clip_scale = draw_data->FramebufferScale; // (1,1) unless using retina display which are often (2,2)
 
     // Render command lists
+    int global_vtx_offset = 0;  // Where the current draw list starts in the streamed segment
+    int global_idx_offset = 0;
     for (int n = 0; n < draw_data->CmdListsCount; n++)
     {
         const ImDrawList* draw_list = draw_data->CmdLists[n];
@@ -598,6 +825,14 @@ void    ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data)
         // - See https://github.com/ocornut/imgui/issues/4468 and please report any corruption issues.
         const GLsizeiptr vtx_buffer_size = (GLsizeiptr)draw_list->VtxBuffer.Size * (int)sizeof(ImDrawVert);
         const GLsizeiptr idx_buffer_size = (GLsizeiptr)draw_list->IdxBuffer.Size * (int)sizeof(ImDrawIdx);
+        const std::chrono::steady_clock::time_point upload_start = std::chrono::steady_clock::now();
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_STREAMING
+        if (bd->UseStreaming)
+        {
+            // Already in the ring
+        }
+        else
+#endif
         if (bd->UseBufferSubData)
         {
             if (bd->VertexBufferSize < vtx_buffer_size)
@@ -618,6 +853,13 @@ void    ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data)
             GL_CALL(glBufferData(GL_ARRAY_BUFFER, vtx_buffer_size, (const GLvoid*)draw_list->VtxBuffer.Data, GL_STREAM_DRAW));
             GL_CALL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, idx_buffer_size, (const GLvoid*)draw_list->IdxBuffer.Data, GL_STREAM_DRAW));
         }
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_STREAMING
+        if (!bd->UseStreaming)
+#endif
+        {
+            upload_time += std::chrono::steady_clock::now() - upload_start;
+            bd->UploadStats.Bytes += (size_t)(vtx_buffer_size + idx_buffer_size);
+        }
 
         for (int cmd_i = 0; cmd_i < draw_list->CmdBuffer.Size; cmd_i++)
         {
@@ -644,6 +886,12 @@ void    ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data)
 
                 // Bind texture, Draw
                 GL_CALL(glBindTexture(GL_TEXTURE_2D, (GLuint)(intptr_t)pcmd->GetTexID()));
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_STREAMING
+                if (bd->UseStreaming)
+                    GL_CALL(glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT,
+                        (void*)(intptr_t)(stream_idx_base + (global_idx_offset + pcmd->IdxOffset) * sizeof(ImDrawIdx)), (GLint)(stream_vtx_base + global_vtx_offset + pcmd->VtxOffset)));
+                else
+#endif
 #ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_VTX_OFFSET
                 if (bd->GlVersion >= 320)
                     GL_CALL(glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, (void*)(intptr_t)(pcmd->IdxOffset * sizeof(ImDrawIdx)), (GLint)pcmd->VtxOffset));
@@ -652,7 +900,18 @@ void    ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data)
                 GL_CALL(glDrawElements(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, (void*)(intptr_t)(pcmd->IdxOffset * sizeof(ImDrawIdx))));
             }
         }
+        global_vtx_offset += draw_list->VtxBuffer.Size;
+        global_idx_offset += draw_list->IdxBuffer.Size;
     }
+    IM_UNUSED(global_vtx_offset);
+    IM_UNUSED(global_idx_offset);
+
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_STREAMING
+    // Mark when the GPU is done with this frame's segment
+    if (bd->UseStreaming)
+        bd->StreamFences[bd->StreamSegment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+#endif
+    bd->UploadStats.CpuMs = std::chrono::duration<double, std::milli>(upload_time).count();
 
     // Destroy the temporary VAO
 #ifdef IMGUI_IMPL_OPENGL_USE_VERTEX_ARRAY
@@ -1019,6 +1278,9 @@ void    ImGui_ImplOpenGL3_DestroyDeviceObjects()
     if (bd->VboHandle)      { glDeleteBuffers(1, &bd->VboHandle); bd->VboHandle = 0; }
     if (bd->ElementsHandle) { glDeleteBuffers(1, &bd->ElementsHandle); bd->ElementsHandle = 0; }
     if (bd->ShaderHandle)   { glDeleteProgram(bd->ShaderHandle); bd->ShaderHandle = 0; }
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_STREAMING
+    ImGui_ImplOpenGL3_DestroyStreamBuffers(bd);
+#endif
 
     // Destroy all textures
     for (ImTextureData* tex : ImGui::GetPlatformIO().Textures)
@@ -1026,6 +1288,36 @@ void    ImGui_ImplOpenGL3_DestroyDeviceObjects()
             ImGui_ImplOpenGL3_DestroyTexture(tex);
 }
 
+bool    ImGui_ImplOpenGL3_SetStreamingUpload(bool enable, void* (*get_proc_address)(const char* name))
+{
+    ImGui_ImplOpenGL3_Data* bd = ImGui_ImplOpenGL3_GetBackendData();
+    IM_ASSERT(bd != nullptr && "Call ImGui_ImplOpenGL3_Init() first");
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_STREAMING
+    ImGui_ImplOpenGL3_DestroyStreamBuffers(bd); // Recreated on the next frame
+    bd->UseStreaming = false;
+    bd->StreamPersistent = false;
+    bd->BufferStorage = nullptr;
+    if (!enable)
+        return true;
+    if (bd->GlVersion < 320 || bd->GlProfileIsES3)
+        return false;
+    if (bd->HasBufferStorage && get_proc_address != nullptr)
+        bd->BufferStorage = (PFN_ImGui_ImplOpenGL3_glBufferStorage)get_proc_address("glBufferStorage");
+    bd->StreamPersistent = (bd->BufferStorage != nullptr);
+    bd->UseStreaming = true;
+    return true;
+#else
+    IM_UNUSED(get_proc_address);
+    return !enable;
+#endif
+}
+
+ImGui_ImplOpenGL3_UploadStats ImGui_ImplOpenGL3_GetUploadStats()
+{
+    ImGui_ImplOpenGL3_Data* bd = ImGui_ImplOpenGL3_GetBackendData();
+    return bd ? bd->UploadStats : ImGui_ImplOpenGL3_UploadStats();
+}
+
 //-----------------------------------------------------------------------------
 
 #if defined(__GNUC__)
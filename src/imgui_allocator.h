@@ -0,0 +1,145 @@
+// imgui_allocator.h
+// Allocator handed to Dear ImGui through ImGui::SetAllocatorFunctions. Small
+// blocks (ImVector growth, draw list buffers, temporary strings) come from
+// per-size-class free lists carved out of 64 KB chunks, so a long session
+// reuses the same memory instead of fragmenting the C heap. Larger blocks go
+// straight to malloc. Counters are kept per frame and in total.
+#pragma once
+#include "imgui.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+using namespace std;
+
+class ImGuiAllocator
+{
+public:
+    static constexpr size_t GRANULE = 16;                  // size class step, also the alignment
+    static constexpr size_t MAX_POOLED = 2048;             // bigger requests use malloc
+    static constexpr size_t CLASSES = MAX_POOLED / GRANULE;
+    static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+    // This frame so far; beginFrame() moves them to the last* counters
+    uint32_t frameAllocations = 0;
+    uint32_t frameFrees = 0;
+    size_t frameBytes = 0;
+
+    uint32_t lastAllocations = 0;
+    uint32_t lastFrees = 0;
+    size_t lastBytes = 0;
+
+    uint64_t totalAllocations = 0;
+    uint64_t pooledAllocations = 0; // served from a free list or a chunk
+    size_t liveBytes = 0;           // requested and not yet freed
+    size_t peakLiveBytes = 0;
+
+    ImGuiAllocator() = default;
+    ImGuiAllocator(const ImGuiAllocator &) = delete;
+    ImGuiAllocator &operator=(const ImGuiAllocator &) = delete;
+
+    ~ImGuiAllocator()
+    {
+        for (void *chunk : chunks)
+            ::free(chunk);
+    }
+
+    // Must run before ImGui::CreateContext, and the allocator must outlive
+    // ImGui::DestroyContext: every block ImGui frees comes back through here.
+    void install() { ImGui::SetAllocatorFunctions(&allocThunk, &freeThunk, this); }
+
+    void beginFrame()
+    {
+        lastAllocations = frameAllocations;
+        lastFrees = frameFrees;
+        lastBytes = frameBytes;
+        frameAllocations = frameFrees = 0;
+        frameBytes = 0;
+    }
+
+    // Bytes held in chunks, whether handed out or waiting in a free list
+    size_t pooledBytes() const { return chunks.size() * CHUNK_SIZE; }
+
+    void *alloc(size_t size)
+    {
+        size_t cls = (size + GRANULE - 1) / GRANULE;
+        Header *h;
+        if (size > 0 && cls <= CLASSES)
+        {
+            h = freeLists[cls - 1];
+            if (h)
+                freeLists[cls - 1] = h->next;
+            else if (!(h = (Header *)carve(GRANULE + cls * GRANULE)))
+                return nullptr;
+            ++pooledAllocations;
+        }
+        else
+        {
+            h = (Header *)::malloc(GRANULE + size);
+            if (!h)
+                return nullptr;
+        }
+        h->size = size;
+        ++frameAllocations;
+        ++totalAllocations;
+        frameBytes += size;
+        liveBytes += size;
+        if (liveBytes > peakLiveBytes)
+            peakLiveBytes = liveBytes;
+        return (char *)h + GRANULE;
+    }
+
+    void free(void *p)
+    {
+        if (!p)
+            return;
+        Header *h = (Header *)((char *)p - GRANULE);
+        ++frameFrees;
+        liveBytes -= h->size;
+        size_t cls = (h->size + GRANULE - 1) / GRANULE;
+        if (h->size > 0 && cls <= CLASSES)
+        {
+            h->next = freeLists[cls - 1];
+            freeLists[cls - 1] = h;
+        }
+        else
+            ::free(h);
+    }
+
+private:
+    // Sits in the GRANULE bytes before each block. A freed block reuses it as
+    // the free-list link; size stays valid so the class is known on reuse.
+    struct Header
+    {
+        size_t size;
+        Header *next;
+    };
+    static_assert(sizeof(Header) <= GRANULE, "header must fit in one granule");
+
+    Header *freeLists[CLASSES] = {};
+    vector<void *> chunks;
+    char *chunkCursor = nullptr;
+    size_t chunkLeft = 0;
+
+    // Fresh memory for a block of `bytes` (header included) from the chunk
+    char *carve(size_t bytes)
+    {
+        if (bytes > chunkLeft)
+        {
+            // The tail of the old chunk is too small for this class; leave it
+            char *chunk = (char *)::malloc(CHUNK_SIZE);
+            if (!chunk)
+                return nullptr;
+            chunks.push_back(chunk);
+            chunkCursor = chunk;
+            chunkLeft = CHUNK_SIZE;
+        }
+        char *p = chunkCursor;
+        chunkCursor += bytes;
+        chunkLeft -= bytes;
+        return p;
+    }
+
+    static void *allocThunk(size_t size, void *self) { return ((ImGuiAllocator *)self)->alloc(size); }
+    static void freeThunk(void *p, void *self) { ((ImGuiAllocator *)self)->free(p); }
+};
@@ -0,0 +1,354 @@
+// imgui_main.cpp
+// Alternative front-end: the roster in a Dear ImGui table (roster_table_view.h)
+// on OpenGL 3.3 core through glad and the vendored GLFW/OpenGL3 backends.
+//
+//   roster_imgui [students.txt] [--generate rows] [--seed n]
+//                [--font file.ttf]... [--font-size px] [--no-font-cache]
+//                [--streaming] [--bench-upload [frames]]
+//
+// --generate fills the roster with synthetic rows instead of loading a file,
+// e.g. --generate 10000000 to check scrolling stays smooth at scale.
+// --font replaces the built-in font; further --font files are merged into the
+// first one for the glyphs it lacks. Glyphs baked in one session are kept in
+// roster_imgui.fontcache (font_atlas_cache.h) and copied back at the next
+// launch; --no-font-cache bakes from scratch to compare cold starts.
+// --streaming switches the OpenGL backend to its fenced ring of vertex buffers
+// (persistently mapped on GL 4.4). --bench-upload renders a synthetic heavy
+// scene with each upload path in turn and prints the CPU upload times.
+// ImGui allocates through ImGuiAllocator (imgui_allocator.h) and the table
+// formats its labels in a FrameArena; F3 shows both sets of counters.
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "imgui.h"
+#include "imgui_impl_glfw.h"
+#include "imgui_impl_opengl3.h"
+#include "student_manager.h"
+#include "roster_generator.h"
+#include "roster_table_view.h"
+#include "font_atlas_cache.h"
+#include "imgui_allocator.h"
+#include "frame_arena.h"
+#include "alloc_stats.h"
+using namespace std;
+
+static const char *USAGE =
+    "Usage: roster_imgui [students.txt] [--generate rows] [--seed n]\n"
+    "                    [--font file.ttf]... [--font-size px] [--no-font-cache]\n"
+    "                    [--streaming] [--bench-upload [frames]]\n";
+
+// glfwGetProcAddress, typed the way the OpenGL backend takes it
+static void *glProc(const char *name) { return (void *)glfwGetProcAddress(name); }
+
+// The built-in font, or the --font files merged into one
+static void addFonts(ImFontAtlas *atlas, const vector<string> &fontPaths, float fontSize)
+{
+    if (fontPaths.empty())
+    {
+        ImFontConfig config;
+        config.SizePixels = fontSize;
+        atlas->AddFontDefault(&config);
+        return;
+    }
+    for (size_t i = 0; i < fontPaths.size(); ++i)
+    {
+        ImFontConfig config;
+        config.MergeMode = i > 0;
+        config.Flags = ImFontFlags_NoLoadError;
+        if (!atlas->AddFontFromFileTTF(fontPaths[i].c_str(), fontSize, &config))
+            cerr << "Could not load font " << fontPaths[i] << "\n";
+    }
+    if (atlas->Fonts.empty())
+        atlas->AddFontDefault();
+}
+
+// ImGui's allocator, the frame arena and operator new, for the last frame
+static void drawAllocOverlay(const ImGuiAllocator &allocator, const FrameArena &arena, uint64_t newCalls)
+{
+    const ImGuiViewport *viewport = ImGui::GetMainViewport();
+    ImGui::SetNextWindowPos(ImVec2(viewport->WorkPos.x + viewport->WorkSize.x - 24.0f,
+                                   viewport->WorkPos.y + viewport->WorkSize.y - 40.0f),
+                            ImGuiCond_Always, ImVec2(1.0f, 1.0f));
+    ImGui::SetNextWindowBgAlpha(0.85f);
+    ImGui::Begin("Allocations", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize |
+                                             ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing |
+                                             ImGuiWindowFlags_NoNav);
+    ImGui::TextUnformatted("last frame");
+    ImGui::Text("ImGui      %4u allocs %4u frees %7zu B", allocator.lastAllocations, allocator.lastFrees,
+                allocator.lastBytes);
+    ImGui::Text("arena      %4u allocs %12zu B", arena.lastAllocations, arena.lastUsed);
+    ImGui::Text("new        %4llu calls", (unsigned long long)newCalls);
+    ImGui::Separator();
+    ImGui::Text("ImGui live %zu KB, peak %zu KB", allocator.liveBytes / 1024, allocator.peakLiveBytes / 1024);
+    ImGui::Text("pool       %zu KB in chunks, %.1f%% of %llu allocs", allocator.pooledBytes() / 1024,
+                allocator.totalAllocations ? 100.0 * allocator.pooledAllocations / allocator.totalAllocations : 0.0,
+                (unsigned long long)allocator.totalAllocations);
+    ImGui::Text("arena      high water %zu of %zu B", arena.highWater, FrameArena::CAPACITY);
+    ImGui::End();
+}
+
+// A frame far heavier than the roster table: thousands of rectangles and
+// text runs in one window, a few hundred thousand vertices in all
+static void drawHeavyScene(int frame)
+{
+    const ImGuiViewport *viewport = ImGui::GetMainViewport();
+    ImGui::SetNextWindowPos(viewport->WorkPos);
+    ImGui::SetNextWindowSize(viewport->WorkSize);
+    ImGui::Begin("Upload bench", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoSavedSettings);
+    ImDrawList *draw = ImGui::GetWindowDrawList();
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    char label[32];
+    for (int i = 0; i < 40000; ++i)
+    {
+        float x = origin.x + (float)((i * 37 + frame) % 1000);
+        float y = origin.y + (float)((i * 11) % 660);
+        draw->AddRectFilled(ImVec2(x, y), ImVec2(x + 12.0f, y + 6.0f), IM_COL32(40 + i % 200, 90, 160, 255));
+    }
+    for (int i = 0; i < 4000; ++i)
+    {
+        snprintf(label, sizeof(label), "row %06d  %.2f", i + frame, (i % 400) / 100.0f);
+        draw->AddText(ImVec2(origin.x + (float)((i % 8) * 130), origin.y + (float)((i / 8) % 660)), IM_COL32_WHITE, label);
+    }
+    ImGui::End();
+}
+
+static double percentile(vector<double> v, double p)
+{
+    if (v.empty())
+        return 0.0;
+    sort(v.begin(), v.end());
+    return v[min(v.size() - 1, (size_t)(p * v.size()))];
+}
+
+// Render the heavy scene with each upload path and report the CPU cost
+static void runUploadBench(GLFWwindow *window, int frames)
+{
+    struct Mode
+    {
+        const char *name;
+        bool streaming;
+        void *(*getProc)(const char *);
+    };
+    const Mode modes[] = {{"glBufferData", false, nullptr}, {"mapped ring", true, nullptr}, {"persistent ring", true, glProc}};
+    glfwSwapInterval(0); // measure the upload, not the vsync wait
+    printf("%-16s %9s %9s %9s %9s %8s %6s %7s\n", "path", "upload50", "upload99", "render50", "render99", "MB/frame",
+           "waits", "orphans");
+    for (const Mode &mode : modes)
+    {
+        if (!ImGui_ImplOpenGL3_SetStreamingUpload(mode.streaming, mode.getProc))
+        {
+            printf("%-16s not available on this GL\n", mode.name);
+            continue;
+        }
+        vector<double> upload, render;
+        double bytes = 0;
+        int waits = 0, orphans = 0;
+        bool persistent = false;
+        for (int f = 0; f < frames + 30 && !glfwWindowShouldClose(window); ++f)
+        {
+            glfwPollEvents();
+            ImGui_ImplOpenGL3_NewFrame();
+            ImGui_ImplGlfw_NewFrame();
+            ImGui::NewFrame();
+            drawHeavyScene(f);
+            ImGui::Render();
+            int w, h;
+            glfwGetFramebufferSize(window, &w, &h);
+            glViewport(0, 0, w, h);
+            glClear(GL_COLOR_BUFFER_BIT);
+            auto start = chrono::steady_clock::now();
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+            glfwSwapBuffers(window);
+            if (f < 30)
+                continue; // warm-up: buffers grow, glyphs bake
+            ImGui_ImplOpenGL3_UploadStats stats = ImGui_ImplOpenGL3_GetUploadStats();
+            upload.push_back(stats.CpuMs);
+            render.push_back(ms);
+            bytes += (double)stats.Bytes;
+            waits += stats.Waits;
+            orphans += stats.Orphans;
+            persistent = stats.Persistent;
+        }
+        if (mode.getProc && !persistent)
+            printf("%-16s (no GL 4.4 buffer storage, fell back to mapping)\n", mode.name);
+        printf("%-16s %9.3f %9.3f %9.3f %9.3f %8.2f %6d %7d\n", mode.name, percentile(upload, 0.5),
+               percentile(upload, 0.99), percentile(render, 0.5), percentile(render, 0.99),
+               upload.empty() ? 0.0 : bytes / upload.size() / (1 << 20), waits, orphans);
+    }
+    ImGui_ImplOpenGL3_SetStreamingUpload(false);
+}
+
+int main(int argc, char **argv)
+{
+    auto startTime = chrono::steady_clock::now();
+    string dataPath = "students.txt";
+    size_t generateRows = 0;
+    uint64_t seed = 42;
+    vector<string> fontPaths;
+    float fontSize = 13.0f;
+    bool useFontCache = true;
+    bool streaming = false;
+    int benchFrames = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        try
+        {
+            if (arg == "--generate" && i + 1 < argc)
+                generateRows = stoull(argv[++i]);
+            else if (arg == "--seed" && i + 1 < argc)
+                seed = stoull(argv[++i]);
+            else if (arg == "--font" && i + 1 < argc)
+                fontPaths.push_back(argv[++i]);
+            else if (arg == "--font-size" && i + 1 < argc)
+                fontSize = stof(argv[++i]);
+            else if (arg == "--no-font-cache")
+                useFontCache = false;
+            else if (arg == "--streaming")
+                streaming = true;
+            else if (arg == "--bench-upload")
+                benchFrames = i + 1 < argc && argv[i + 1][0] != '-' ? stoi(argv[++i]) : 600;
+            else if (arg[0] != '-')
+                dataPath = arg;
+            else
+            {
+                cerr << USAGE;
+                return 2;
+            }
+        }
+        catch (...)
+        {
+            cerr << "Bad number for " << arg << "\n";
+            return 2;
+        }
+    }
+
+    StudentManager manager;
+    if (generateRows > 0)
+    {
+        RosterGenerator generator(seed);
+        manager.assign(generator.generate(generateRows));
+    }
+    else
+        manager.load(dataPath);
+
+    if (!glfwInit())
+    {
+        cerr << "GLFW init failed\n";
+        return -1;
+    }
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifdef __APPLE__
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GLFW_TRUE);
+#endif
+    GLFWwindow *window = glfwCreateWindow(1100, 720, "Student Management (ImGui)", NULL, NULL);
+    if (!window)
+    {
+        cerr << "Window create failed\n";
+        glfwTerminate();
+        return -1;
+    }
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(1);
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        cerr << "Could not load OpenGL 3.3\n";
+        glfwTerminate();
+        return -1;
+    }
+
+    // Before CreateContext, so every ImGui block goes through it
+    static ImGuiAllocator allocator;
+    allocator.install();
+
+    IMGUI_CHECKVERSION();
+    ImGui::CreateContext();
+    ImGui::GetIO().IniFilename = "roster_imgui.ini"; // keeps column widths and order
+    ImGui::StyleColorsDark();
+    ImGui_ImplGlfw_InitForOpenGL(window, true);
+    ImGui_ImplOpenGL3_Init("#version 330 core");
+
+    ImFontAtlas *fonts = ImGui::GetIO().Fonts;
+    addFonts(fonts, fontPaths, fontSize);
+    FontAtlasCache fontCache;
+    if (useFontCache && !fontCache.load(fonts))
+        cerr << "Font cache: " << fontCache.error << ", baking glyphs\n";
+
+    if (streaming && !ImGui_ImplOpenGL3_SetStreamingUpload(true, glProc))
+        cerr << "Streaming upload needs OpenGL 3.2; using glBufferData\n";
+
+    if (benchFrames > 0)
+    {
+        runUploadBench(window, benchFrames);
+        ImGui_ImplOpenGL3_Shutdown();
+        ImGui_ImplGlfw_Shutdown();
+        ImGui::DestroyContext();
+        glfwTerminate();
+        return 0;
+    }
+
+    RosterTableView view;
+    static FrameArena frameArena;
+    bool firstFrame = true;
+    bool showAllocations = false;
+    uint64_t newCalls = 0, frameNewStart = AllocStats::count();
+    while (!glfwWindowShouldClose(window))
+    {
+        allocator.beginFrame();
+        frameArena.reset();
+        newCalls = AllocStats::count() - frameNewStart;
+        frameNewStart = AllocStats::count();
+        glfwPollEvents();
+        ImGui_ImplOpenGL3_NewFrame();
+        ImGui_ImplGlfw_NewFrame();
+        ImGui::NewFrame();
+
+        // One undecorated window covering the whole viewport
+        const ImGuiViewport *viewport = ImGui::GetMainViewport();
+        ImGui::SetNextWindowPos(viewport->WorkPos);
+        ImGui::SetNextWindowSize(viewport->WorkSize);
+        // No NoSavedSettings here: the table inherits it, and the ini would
+        // lose its column widths and order
+        ImGui::Begin("Roster", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoMove |
+                                            ImGuiWindowFlags_NoBringToFrontOnFocus);
+        view.draw(manager, frameArena);
+        ImGui::End();
+
+        if (ImGui::IsKeyPressed(ImGuiKey_F3, false))
+            showAllocations = !showAllocations;
+        if (showAllocations)
+            drawAllocOverlay(allocator, frameArena, newCalls);
+
+        ImGui::Render();
+        int w, h;
+        glfwGetFramebufferSize(window, &w, &h);
+        glViewport(0, 0, w, h);
+        glClearColor(0.06f, 0.07f, 0.08f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        glfwSwapBuffers(window);
+
+        if (firstFrame)
+        {
+            double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - startTime).count();
+            cerr << "First frame after " << ms << " ms (" << fontCache.restoredGlyphs << " glyphs from the font cache)\n";
+            firstFrame = false;
+        }
+    }
+
+    if (useFontCache && !fontCache.save(fonts))
+        cerr << "Font cache: " << fontCache.error << "\n";
+    ImGui_ImplOpenGL3_Shutdown();
+    ImGui_ImplGlfw_Shutdown();
+    ImGui::DestroyContext();
+    glfwTerminate();
+    return 0;
+}
@@ -0,0 +1,74 @@
+// input_queue.h
+// Timestamped input events handed from the GLFW callbacks to the main loop
+// through a lock-free single-producer/single-consumer ring. The callbacks only
+// push; the loop pops every event in arrival order, so fast clicks and typing
+// are never merged or lost between frames.
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+using namespace std;
+
+class InputEvent
+{
+public:
+    enum Type : uint8_t
+    {
+        CURSOR,       // x, y: window position, top-left origin
+        MOUSE_BUTTON, // code: button, action: press/release
+        KEY,          // code: key, action: press/release/repeat
+        CHAR,         // code: Unicode codepoint
+        SCROLL        // x, y: wheel or touchpad offset, positive y away from the user
+    };
+
+    Type type = CURSOR;
+    double time = 0; // glfwGetTime() when the callback ran
+    double x = 0, y = 0;
+    int code = 0;
+    int action = 0;
+    int mods = 0;
+};
+
+template <typename T, size_t CAPACITY>
+class SpscRing
+{
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "capacity must be a power of two");
+
+public:
+    // Producer side. A full ring drops the event rather than block the callback.
+    bool push(const T &value)
+    {
+        size_t h = head.load(memory_order_relaxed);
+        if (h - tail.load(memory_order_acquire) == CAPACITY)
+        {
+            dropped.fetch_add(1, memory_order_relaxed);
+            return false;
+        }
+        slots[h & (CAPACITY - 1)] = value;
+        head.store(h + 1, memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    bool pop(T &out)
+    {
+        size_t t = tail.load(memory_order_relaxed);
+        if (t == head.load(memory_order_acquire))
+            return false;
+        out = slots[t & (CAPACITY - 1)];
+        tail.store(t + 1, memory_order_release);
+        return true;
+    }
+
+    size_t size() const { return head.load(memory_order_acquire) - tail.load(memory_order_acquire); }
+    uint64_t droppedCount() const { return dropped.load(memory_order_relaxed); }
+
+private:
+    // head and tail on separate cache lines so producer and consumer don't share one
+    alignas(64) atomic<size_t> head{0};
+    alignas(64) atomic<size_t> tail{0};
+    atomic<uint64_t> dropped{0};
+    T slots[CAPACITY];
+};
+
+using InputQueue = SpscRing<InputEvent, 1024>;
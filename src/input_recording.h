@@ -0,0 +1,247 @@
+// input_recording.h
+// Session recording for the GUI: the clock value of every frame, the input
+// events it consumed and the window size it was laid out at. Replaying a
+// recording feeds the same events through the same handlers on a virtual
+// clock, at the same layout, so a session becomes a repeatable frame-time
+// benchmark.
+//
+// File format (text, one record per line):
+//   studentgui-recording 2
+//   roster <snapshot of the roster taken when recording started>
+//   F <time>                                         start of a frame
+//   L <fb width> <fb height> <scale> <cursor scale>  window laid out in that frame
+//   E <type> <time> <x> <y> <code> <action> <mods>  event consumed by that frame
+// Version 1 recordings have no L records and replay at the default size.
+#pragma once
+#include "input_queue.h"
+#include "frame_profiler.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+using namespace std;
+
+// The window metrics a frame was laid out with (see WindowMetrics)
+class RecordedLayout
+{
+public:
+    int framebufferW = 0, framebufferH = 0;
+    float scale = 1.0f, cursorScale = 1.0f;
+};
+
+class InputRecorder
+{
+public:
+    ~InputRecorder() { close(); }
+
+    bool open(const string &path, const string &rosterPath)
+    {
+        f = fopen(path.c_str(), "w");
+        if (!f)
+            return false;
+        fprintf(f, "studentgui-recording 2\nroster %s\n", rosterPath.c_str());
+        return true;
+    }
+
+    bool active() const { return f != nullptr; }
+
+    void frame(double time)
+    {
+        if (f)
+            fprintf(f, "F %.6f\n", time);
+    }
+
+    void layout(const RecordedLayout &l)
+    {
+        if (f)
+            fprintf(f, "L %d %d %.6f %.6f\n", l.framebufferW, l.framebufferH, l.scale, l.cursorScale);
+    }
+
+    void event(const InputEvent &e)
+    {
+        if (f)
+            fprintf(f, "E %d %.6f %.2f %.2f %d %d %d\n", (int)e.type, e.time, e.x, e.y, e.code, e.action, e.mods);
+    }
+
+    void close()
+    {
+        if (f)
+            fclose(f);
+        f = nullptr;
+    }
+
+private:
+    FILE *f = nullptr;
+};
+
+class RecordedFrame
+{
+public:
+    double time;
+    size_t firstEvent;
+    size_t eventCount;
+    int layout; // index into InputReplay::layouts, or -1 when not laid out
+};
+
+class InputReplay
+{
+public:
+    vector<RecordedFrame> frames;
+    vector<InputEvent> events;
+    vector<RecordedLayout> layouts;
+    string rosterPath;
+    string error;
+    size_t next = 0; // frame advance() hands out next
+
+    bool load(const string &path)
+    {
+        ifstream in(path);
+        string line;
+        if (!in.is_open() || !getline(in, line) ||
+            (line != "studentgui-recording 1" && line != "studentgui-recording 2"))
+        {
+            error = "not a recording: " + path;
+            return false;
+        }
+        while (getline(in, line))
+        {
+            if (line.rfind("roster ", 0) == 0)
+                rosterPath = line.substr(7);
+            else if (line.size() > 2 && line[0] == 'F')
+                frames.push_back({atof(line.c_str() + 2), events.size(), 0, -1});
+            else if (line.size() > 2 && line[0] == 'L' && !frames.empty())
+            {
+                RecordedLayout l;
+                if (sscanf(line.c_str() + 2, "%d %d %f %f", &l.framebufferW, &l.framebufferH, &l.scale, &l.cursorScale) != 4 ||
+                    l.framebufferW <= 0 || l.framebufferH <= 0 || l.scale <= 0 || l.cursorScale <= 0)
+                    continue;
+                frames.back().layout = (int)layouts.size();
+                layouts.push_back(l);
+            }
+            else if (line.size() > 2 && line[0] == 'E' && !frames.empty())
+            {
+                InputEvent e;
+                int type = 0;
+                if (sscanf(line.c_str() + 2, "%d %lf %lf %lf %d %d %d", &type, &e.time, &e.x, &e.y, &e.code, &e.action, &e.mods) != 7)
+                    continue;
+                e.type = (InputEvent::Type)type;
+                events.push_back(e);
+                ++frames.back().eventCount;
+            }
+        }
+        if (frames.empty())
+        {
+            error = "recording has no frames: " + path;
+            return false;
+        }
+        return true;
+    }
+
+    bool done() const { return next >= frames.size(); }
+
+    // Whether the window sizes came with the recording; version 1 files lack them
+    bool hasLayouts() const { return !layouts.empty(); }
+
+    // The layout of the frame advance() last handed out, if it had one
+    const RecordedLayout *layout() const
+    {
+        int i = next ? frames[next - 1].layout : -1;
+        return i < 0 ? nullptr : &layouts[i];
+    }
+
+    // Queue the next frame's events and return the clock value it ran at
+    double advance(InputQueue &queue)
+    {
+        const RecordedFrame &fr = frames[next++];
+        for (size_t i = 0; i < fr.eventCount; ++i)
+            queue.push(events[fr.firstEvent + i]);
+        return fr.time;
+    }
+};
+
+// Per-phase frame times of a whole replay, printed and optionally written as JSON
+class ReplayReport
+{
+public:
+    vector<float> phaseMs[FrameProfiler::PHASES];
+    double wallSeconds = 0;
+
+    void reserve(size_t frames)
+    {
+        for (auto &v : phaseMs)
+            v.reserve(frames);
+    }
+
+    void add(const float *sample)
+    {
+        for (int p = 0; p < FrameProfiler::PHASES; ++p)
+            phaseMs[p].push_back(sample[p]);
+    }
+
+    class Summary
+    {
+    public:
+        float p50 = 0, p95 = 0, p99 = 0, max = 0;
+        double mean = 0;
+    };
+
+    Summary summarize(int phase) const
+    {
+        vector<float> v = phaseMs[phase];
+        Summary s;
+        if (v.empty())
+            return s;
+        sort(v.begin(), v.end());
+        auto at = [&](double p)
+        {
+            size_t rank = (size_t)(p * v.size() + 0.999);
+            return v[rank == 0 ? 0 : rank - 1];
+        };
+        s.p50 = at(0.50);
+        s.p95 = at(0.95);
+        s.p99 = at(0.99);
+        s.max = v.back();
+        for (float x : v)
+            s.mean += x;
+        s.mean /= v.size();
+        return s;
+    }
+
+    void print() const
+    {
+        printf("%zu frames in %.2f s\n", phaseMs[0].size(), wallSeconds);
+        printf("phase      mean     p50     p95     p99     max ms\n");
+        for (int p = 0; p < FrameProfiler::PHASES; ++p)
+        {
+            Summary s = summarize(p);
+            printf("%-6s %8.3f %7.3f %7.3f %7.3f %7.3f\n", FrameProfiler::phaseName(p), s.mean, s.p50, s.p95, s.p99, s.max);
+        }
+    }
+
+    bool writeJson(const string &path, const string &recording) const
+    {
+        ofstream f(path);
+        if (!f.is_open())
+            return false;
+        string name;
+        for (char c : recording)
+        {
+            if (c == '"' || c == '\\')
+                name += '\\';
+            name += c;
+        }
+        f << "{\n  \"recording\": \"" << name << "\",\n  \"frames\": " << phaseMs[0].size()
+          << ",\n  \"wall_seconds\": " << wallSeconds << ",\n  \"phases\": [\n";
+        for (int p = 0; p < FrameProfiler::PHASES; ++p)
+        {
+            Summary s = summarize(p);
+            f << "    {\"phase\": \"" << FrameProfiler::phaseName(p) << "\", \"mean_ms\": " << s.mean
+              << ", \"p50_ms\": " << s.p50 << ", \"p95_ms\": " << s.p95 << ", \"p99_ms\": " << s.p99
+              << ", \"max_ms\": " << s.max << "}" << (p + 1 < FrameProfiler::PHASES ? ",\n" : "\n");
+        }
+        f << "  ]\n}\n";
+        return true;
+    }
+};
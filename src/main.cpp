@@ -1,5 +1,6 @@
 // main.cpp
-// 2D Student Management GUI using OpenGL 2.1 (compatibility mode)
+// 2D Student Management GUI on OpenGL 3.3 core, drawn through ui_renderer.h
+#include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <iostream>
 #include <vector>
@@ -7,24 +8,25 @@
 #include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <cmath>
 #include <cstring>
 #include <iomanip>
+#include "student_manager.h"
+#include "frame_profiler.h"
+#include "frame_arena.h"
+#include "input_queue.h"
+#include "input_recording.h"
+#include "roster_client.h"
+#include "ui_renderer.h"
 using namespace std;
 
 // ------------------------- stb_easy_font -------------------------
 #define STB_EASY_FONT_IMPLEMENTATION
 #include "stb_easy_font.h" // place stb_easy_font.h in the same folder
 
-// ------------------------- Student Structures -------------------------
-class Student
-{
-public:
-    string name;
-    int roll;
-    string grade;
-    string department;
-    float cgpa;
-};
+// ------------------------- UI Structures -------------------------
+// Each element sets `dirty` when what it shows has changed since it was last
+// drawn into the backing store; the main loop turns that into damage
 class Button
 {
 public:
@@ -32,6 +34,18 @@ public:
     string label;
     bool pressed = false;
     double pressTime = 0.0;
+    bool dirty = true;
+    bool drawnPressed = false;
+
+    // Shown lowered and darker for 0.2s after a click
+    bool showsPress(double currentTime) const { return pressed && currentTime - pressTime < 0.2; }
+
+    void update(double currentTime)
+    {
+        bool press = showsPress(currentTime);
+        dirty |= press != drawnPressed;
+        drawnPressed = press;
+    }
 };
 class InputBox
 {
@@ -39,6 +53,18 @@ public:
     float x, y, w, h;
     string text;
     bool focused = false;
+    bool dirty = true;
+    string drawnText = {};
+    bool drawnFocused = false;
+
+    void update()
+    {
+        if (text == drawnText && focused == drawnFocused)
+            return;
+        drawnText = text;
+        drawnFocused = focused;
+        dirty = true;
+    }
 };
 
 // Message popup structure
@@ -49,6 +75,8 @@ public:
     double showTime;
     double duration;
     bool visible;
+    bool dirty = false;
+    float drawnAlpha = 0.0f;
 
     MessagePopup() : text(""), showTime(0), duration(1.2), visible(false) {}
 
@@ -57,6 +85,15 @@ public:
         text = msg;
         showTime = currentTime;
         visible = true;
+        dirty = true;
+    }
+
+    // Fading in or out, or gone since the last draw
+    void update(double currentTime)
+    {
+        float alpha = getAlpha(currentTime);
+        dirty |= alpha != drawnAlpha;
+        drawnAlpha = alpha;
     }
 
     bool isVisible(double currentTime) const
@@ -95,12 +132,15 @@ public:
     Student *currentStudent;
     double animationStart;
     double animationDuration;
+    bool dirty = false;
+    float drawnProgress = 0.0f;
 
     DetailsPanel() : visible(false), currentStudent(nullptr), animationStart(0), animationDuration(0.3) {}
 
     void show(Student *student, double currentTime)
     {
         currentStudent = student;
+        dirty = true;
         if (!visible)
         {
             visible = true;
@@ -112,6 +152,14 @@ public:
     {
         visible = false;
         currentStudent = nullptr;
+        dirty = true;
+    }
+
+    void update(double currentTime)
+    {
+        float progress = getSlideProgress(currentTime);
+        dirty |= progress != drawnProgress;
+        drawnProgress = progress;
     }
 
     float getSlideProgress(double currentTime) const
@@ -129,239 +177,333 @@ public:
     }
 };
 
-// Sorting state
-enum class SortColumn
-{
-    NONE,
-    ROLL,
-    NAME,
-    GRADE,
-    DEPARTMENT,
-    CGPA
-};
-class SortState
+// Statistics panel structure, docked beside the details panel
+class StatsPanel
 {
 public:
-    SortColumn column = SortColumn::NONE;
-    bool ascending = true;
+    bool visible;
+    double animationStart;
+    double animationDuration;
+    bool dirty = false;
+    float drawnProgress = 0.0f;
+
+    StatsPanel() : visible(false), animationStart(0), animationDuration(0.3) {}
+
+    void update(double currentTime)
+    {
+        float progress = getSlideProgress(currentTime);
+        dirty |= progress != drawnProgress;
+        drawnProgress = progress;
+    }
+
+    void toggle(double currentTime)
+    {
+        visible = !visible;
+        if (visible)
+            animationStart = currentTime;
+    }
+
+    float getSlideProgress(double currentTime) const
+    {
+        if (!visible)
+            return 0.0f;
+
+        double elapsed = currentTime - animationStart;
+        if (elapsed >= animationDuration)
+            return 1.0f;
+
+        float t = (float)(elapsed / animationDuration);
+        return t * t * (3.0f - 2.0f * t); // Smoothstep
+    }
 };
 
-class StudentManager
+// Leaderboard panel structure, shares the slot beside the details panel with StatsPanel
+class LeaderboardPanel
 {
 public:
-    vector<Student> students;
-    SortState sortState;
+    bool visible;
+    double animationStart;
+    double animationDuration;
 
-    void add(const Student &s) { students.push_back(s); }
-    void removeByRoll(int roll)
-    {
-        students.erase(remove_if(students.begin(), students.end(),
-                                 [roll](const Student &s)
-                                 { return s.roll == roll; }),
-                       students.end());
-    }
-    Student *findByRoll(int roll)
+    // Boards as of manager version `boardsVersion`, refreshed only when the roster changes
+    vector<pair<string, vector<Leaderboard::Entry>>> boards;
+    uint64_t boardsVersion = ~0ULL;
+    bool dirty = false;
+    float drawnProgress = 0.0f;
+
+    LeaderboardPanel() : visible(false), animationStart(0), animationDuration(0.3) {}
+
+    void update(double currentTime)
     {
-        for (auto &s : students)
-            if (s.roll == roll)
-                return &s;
-        return nullptr;
+        float progress = getSlideProgress(currentTime);
+        dirty |= progress != drawnProgress;
+        drawnProgress = progress;
     }
-    vector<Student *> search(const string &q)
+
+    void toggle(double currentTime)
     {
-        vector<Student *> out;
-        string lowerq = q;
-        transform(lowerq.begin(), lowerq.end(), lowerq.begin(), ::tolower);
-        for (auto &s : students)
-        {
-            string lname = s.name;
-            transform(lname.begin(), lname.end(), lname.begin(), ::tolower);
-            string sroll = to_string(s.roll);
-            if (lname.find(lowerq) != string::npos || sroll.find(lowerq) != string::npos)
-                out.push_back(&s);
-        }
-        return out;
+        visible = !visible;
+        if (visible)
+            animationStart = currentTime;
     }
 
-    void sortBy(SortColumn column)
+    float getSlideProgress(double currentTime) const
     {
-        if (sortState.column == column)
-        {
-            // Same column - toggle direction
-            sortState.ascending = !sortState.ascending;
-        }
-        else
-        {
-            // New column - default to ascending
-            sortState.column = column;
-            sortState.ascending = true;
-        }
+        if (!visible)
+            return 0.0f;
 
-        // Perform sort
-        switch (column)
-        {
-        case SortColumn::ROLL:
-            sort(students.begin(), students.end(), [this](const Student &a, const Student &b)
-                 { return sortState.ascending ? (a.roll < b.roll) : (a.roll > b.roll); });
-            break;
-        case SortColumn::NAME:
-            sort(students.begin(), students.end(), [this](const Student &a, const Student &b)
-                 { return sortState.ascending ? (a.name < b.name) : (a.name > b.name); });
-            break;
-        case SortColumn::GRADE:
-            sort(students.begin(), students.end(), [this](const Student &a, const Student &b)
-                 { return sortState.ascending ? (a.grade < b.grade) : (a.grade > b.grade); });
-            break;
-        case SortColumn::DEPARTMENT:
-            sort(students.begin(), students.end(), [this](const Student &a, const Student &b)
-                 { return sortState.ascending ? (a.department < b.department) : (a.department > b.department); });
-            break;
-        case SortColumn::CGPA:
-            sort(students.begin(), students.end(), [this](const Student &a, const Student &b)
-                 { return sortState.ascending ? (a.cgpa < b.cgpa) : (a.cgpa > b.cgpa); });
-            break;
-        default:
-            break;
-        }
+        double elapsed = currentTime - animationStart;
+        if (elapsed >= animationDuration)
+            return 1.0f;
+
+        float t = (float)(elapsed / animationDuration);
+        return t * t * (3.0f - 2.0f * t); // Smoothstep
     }
+};
+
+// Scroll position of the student list, in pixels scrolled down. The wheel and
+// keys move `target`; `offset`, which is what gets drawn, eases toward it over
+// time, so it moves the same at any frame rate. Wheel notches that arrive while
+// it is still moving add to the target, so a fast spin glides further. Doubles
+// keep whole pixels exact far past ten million rows.
+class KineticScroll
+{
+public:
+    static constexpr double TIME_CONSTANT = 0.06; // seconds to close 63% of the distance
+
+    double offset = 0.0;
+    double target = 0.0;
+    double maxOffset = 0.0;
+    double lastTime = 0.0;
 
-    void save(const string &fname = "students.txt")
+    void setRange(double contentHeight, double viewHeight)
     {
-        ofstream f(fname);
-        for (auto &s : students)
-            f << s.name << '\t' << s.roll << '\t' << s.grade << '\t' << s.department << '\t' << s.cgpa << '\n';
+        maxOffset = max(0.0, contentHeight - viewHeight);
+        target = min(target, maxOffset);
+        offset = min(offset, maxOffset);
     }
-    void load(const string &fname = "students.txt")
+
+    void scrollBy(double pixels) { scrollTo(target + pixels); }
+    void scrollTo(double pixels) { target = min(max(pixels, 0.0), maxOffset); }
+
+    // Back to the top at once, as for a new search
+    void reset() { offset = target = 0.0; }
+
+    void update(double currentTime)
     {
-        students.clear();
-        ifstream f(fname);
-        if (!f.is_open())
-            return;
-        string line;
-        while (getline(f, line))
-        {
-            if (line.empty())
-                continue;
-            stringstream ss(line);
-            string name, grade, department;
-            int roll;
-            float cgpa;
-            getline(ss, name, '\t');
-            ss >> roll;
-            ss.get();
-            getline(ss, grade, '\t');
-            getline(ss, department, '\t');
-            ss >> cgpa;
-            students.push_back({name, roll, grade, department, cgpa});
-        }
+        double dt = max(0.0, currentTime - lastTime);
+        lastTime = currentTime;
+        double remaining = target - offset;
+        if (fabs(remaining) < 0.5)
+            offset = target;
+        else
+            offset += remaining * (1.0 - exp(-dt / TIME_CONSTANT));
     }
 };
 
-// ------------------------- Global Input -------------------------
-static double mouseX = 0, mouseY = 0;
-static bool mousePressed = false, mouseJustPressed = false;
-static bool keysDown[1024] = {0};
-static string textInputBuffer;
-static double lastClickTime = 0.0;
+// ------------------------- Input Events -------------------------
+// Callbacks only record what happened; the main loop consumes the queue
+static InputQueue inputQueue;
 static const double DOUBLE_CLICK_TIME = 0.3; // 300ms for double click
 
+static void pushInput(InputEvent::Type type, double x, double y, int code, int action, int mods)
+{
+    InputEvent e;
+    e.type = type;
+    e.time = glfwGetTime();
+    e.x = x;
+    e.y = y;
+    e.code = code;
+    e.action = action;
+    e.mods = mods;
+    inputQueue.push(e);
+}
+
 static void cursor_cb(GLFWwindow *w, double x, double y)
 {
-    mouseX = x;
-    mouseY = y;
+    pushInput(InputEvent::CURSOR, x, y, 0, 0, 0);
 }
 static void mouse_cb(GLFWwindow *w, int button, int action, int mods)
 {
-    if (button == GLFW_MOUSE_BUTTON_LEFT)
-    {
-        if (action == GLFW_PRESS)
-        {
-            mousePressed = true;
-            mouseJustPressed = true;
-        }
-        else if (action == GLFW_RELEASE)
-            mousePressed = false;
-    }
+    pushInput(InputEvent::MOUSE_BUTTON, 0, 0, button, action, mods);
 }
 static void key_cb(GLFWwindow *w, int key, int sc, int action, int mods)
 {
-    if (key >= 0 && key < 1024)
-    {
-        if (action == GLFW_PRESS)
-            keysDown[key] = true;
-        if (action == GLFW_RELEASE)
-            keysDown[key] = false;
-    }
+    pushInput(InputEvent::KEY, 0, 0, key, action, mods);
 }
 static void char_cb(GLFWwindow *w, unsigned int cp)
 {
-    if (cp >= 32 && cp < 128)
-        textInputBuffer.push_back((char)cp);
-    else if (cp == 8 && !textInputBuffer.empty())
-        textInputBuffer.pop_back();
+    pushInput(InputEvent::CHAR, 0, 0, (int)cp, 0, 0);
+}
+static void scroll_cb(GLFWwindow *, double dx, double dy)
+{
+    pushInput(InputEvent::SCROLL, dx, dy, 0, 0, 0);
 }
 
+// ------------------------- Window -------------------------
+// Set when the framebuffer size or content scale changes; the main loop lays
+// the window out again once, however many callbacks arrived
+static bool layoutStale = true;
+
+static void framebuffer_size_cb(GLFWwindow *, int, int)
+{
+    layoutStale = true;
+}
+static void content_scale_cb(GLFWwindow *, float, float)
+{
+    layoutStale = true;
+}
+
+// The window's size in logical pixels: framebuffer pixels divided by the
+// content scale, so on a HiDPI display the UI keeps its size and gets sharper.
+// Cursor positions come in screen coordinates, which are framebuffer pixels on
+// some platforms and logical ones on others.
+class WindowMetrics
+{
+public:
+    static constexpr int MIN_W = 1000, MIN_H = 520; // the search hint runs to the right edge at 1000
+
+    int framebufferW = 0, framebufferH = 0;
+    float scale = 1.0f;       // framebuffer pixels per logical pixel
+    float width = 0, height = 0;
+    float cursorScale = 1.0f; // screen coordinates to logical pixels
+
+    // False while the window is minimised and has nothing to lay out
+    bool read(GLFWwindow *window)
+    {
+        int screenW = 0, screenH = 0;
+        float scaleX = 1.0f, scaleY = 1.0f;
+        glfwGetFramebufferSize(window, &framebufferW, &framebufferH);
+        glfwGetWindowSize(window, &screenW, &screenH);
+        glfwGetWindowContentScale(window, &scaleX, &scaleY);
+        if (framebufferW <= 0 || framebufferH <= 0 || screenW <= 0)
+            return false;
+        scale = scaleX > 0 ? scaleX : 1.0f;
+        apply({framebufferW, framebufferH, scale, (float)framebufferW / screenW / scale});
+        return true;
+    }
+
+    // Take the metrics from a recording instead of the window
+    void apply(const RecordedLayout &l)
+    {
+        framebufferW = l.framebufferW;
+        framebufferH = l.framebufferH;
+        scale = l.scale;
+        cursorScale = l.cursorScale;
+        width = framebufferW / scale;
+        height = framebufferH / scale;
+    }
+
+    RecordedLayout recorded() const { return {framebufferW, framebufferH, scale, cursorScale}; }
+};
+
 static bool pointInRect(float px, float py, float x, float y, float w, float h)
 {
     return (px >= x && px <= x + w && py >= y && py <= y + h);
 }
 
 // ------------------------- Render Helpers -------------------------
+// Frame phase timings, shown by the F3 overlay
+static FrameProfiler profiler;
+
+// Scratch text for the current frame (row labels, headers)
+static FrameArena frameArena;
+
+// Everything below draws into this batch; the main loop flushes it once a frame
+static UiRenderer renderer;
+
+// The list rows as instanced rectangles; see buildListLayer
+static RectInstances listLayer;
+
+// The drawn rows, kept between frames so an unchanged list is only copied
+static RegionCache listCache;
+
+// The whole window, kept between frames; only damaged areas are redrawn
+static BackingStore backing;
+static DamageRegion damage;
+
 void drawRect(float x, float y, float w, float h, float r, float g, float b, float alpha = 1.0f)
 {
-    glColor4f(r, g, b, alpha);
-    glBegin(GL_QUADS);
-    glVertex2f(x, y);
-    glVertex2f(x + w, y);
-    glVertex2f(x + w, y + h);
-    glVertex2f(x, y + h);
-    glEnd();
+    renderer.rect(x, y, w, h, UiRenderer::packColor(r, g, b, alpha));
 }
 
 void drawOutline(float x, float y, float w, float h, float r, float g, float b)
 {
-    glColor3f(r, g, b);
-    glBegin(GL_LINE_LOOP);
-    glVertex2f(x, y);
-    glVertex2f(x + w, y);
-    glVertex2f(x + w, y + h);
-    glVertex2f(x, y + h);
-    glEnd();
+    renderer.outline(x, y, w, h, UiRenderer::packColor(r, g, b, 1.0f));
 }
 
-void drawText(float x, float y, const string &text, float r, float g, float b, int SCR_H, float scale = 2.0f, float alpha = 1.0f)
+// Lay text out with stb_easy_font and pass each of its rectangles, in window
+// coordinates, to out(x, y, w, h)
+template <class Out>
+static void layoutText(float x, float y, const char *text, int SCR_H, float scale, Out out)
 {
     static char buffer[99999];
 
     float flipped_y = SCR_H - y;
 
-    int num_quads = stb_easy_font_print(x, flipped_y, (char *)text.c_str(), NULL, buffer, sizeof(buffer));
+    int num_quads = stb_easy_font_print(x, flipped_y, (char *)text, NULL, buffer, sizeof(buffer));
 
-    glColor4f(r, g, b, alpha);
-
-    glMatrixMode(GL_PROJECTION);
-    glPushMatrix();
-    glLoadIdentity();
-    glOrtho(0, 800, 700, 0, -1, 1);
+    // stb_easy_font lays out top-down; text is scaled about its origin. Its
+    // x units are 1.25 pixels wide, as when an 800-unit space was stretched
+    // over the 1000-pixel window, and stay that wide at any window size
+    const float toX = 1.25f;
+    const float *v = (const float *)buffer;
+    for (int q = 0; q < num_quads; ++q, v += 16)
+    {
+        // Each vertex is x, y, z and a packed colour: 16 bytes
+        float x0 = (x + (v[0] - x) * scale) * toX, y0 = SCR_H - (flipped_y + (v[1] - flipped_y) * scale);
+        float x1 = (x + (v[8] - x) * scale) * toX, y1 = SCR_H - (flipped_y + (v[9] - flipped_y) * scale);
+        out(x0, y1, x1 - x0, y0 - y1);
+    }
+}
 
-    glMatrixMode(GL_MODELVIEW);
-    glPushMatrix();
-    glLoadIdentity();
+void drawText(float x, float y, const char *text, float r, float g, float b, int SCR_H, float scale = 2.0f, float alpha = 1.0f)
+{
+    ProfileScope textScope(profiler, FramePhase::TEXT);
+    uint32_t color = UiRenderer::packColor(r, g, b, alpha);
+    layoutText(x, y, text, SCR_H, scale, [&](float rx, float ry, float rw, float rh)
+               { renderer.rect(rx, ry, rw, rh, color); });
+}
 
-    // Apply scaling for larger text
-    glTranslatef(x, flipped_y, 0);
-    glScalef(scale, scale, 1.0f);
-    glTranslatef(-x, -flipped_y, 0);
+void drawText(float x, float y, const string &text, float r, float g, float b, int SCR_H, float scale = 2.0f, float alpha = 1.0f)
+{
+    drawText(x, y, text.c_str(), r, g, b, SCR_H, scale, alpha);
+}
 
-    glEnableClientState(GL_VERTEX_ARRAY);
-    glVertexPointer(2, GL_FLOAT, 16, buffer);
-    glDrawArrays(GL_QUADS, 0, num_quads * 4);
-    glDisableClientState(GL_VERTEX_ARRAY);
+// Rows [first, end) of `visible`: background and five cells each, laid out as
+// if row `first` were the top row of an unscrolled list. Drawing the layer at
+// a vertical offset then puts any of its rows anywhere in the list.
+static void buildListLayer(const vector<Student *> &visible, const vector<int> &selectedRolls, size_t first, size_t end,
+                           float listX, float listTop, float listW, int SCR_H)
+{
+    ProfileScope textScope(profiler, FramePhase::TEXT);
+    const uint32_t rowColor = UiRenderer::packColor(0.15f, 0.16f, 0.17f, 1.0f);
+    const uint32_t selectedColor = UiRenderer::packColor(0.2f, 0.4f, 0.6f, 1.0f); // blue highlight
+    const uint32_t textColor = UiRenderer::packColor(0.9f, 0.9f, 0.9f, 1.0f);
+    char label[32];
+    listLayer.instances.clear();
+    for (size_t i = first; i < end; ++i)
+    {
+        const Student *s = visible[i];
+        float itemY = listTop - 50 - (float)(i - first) * 24;
+        bool isSelected = find(selectedRolls.begin(), selectedRolls.end(), s->roll) != selectedRolls.end();
+        listLayer.instances.push_back({listX + 5, itemY - 18, listW - 10, 20, isSelected ? selectedColor : rowColor});
 
-    glPopMatrix();
-    glMatrixMode(GL_PROJECTION);
-    glPopMatrix();
-    glMatrixMode(GL_MODELVIEW);
+        auto cell = [&](float x, const char *text)
+        {
+            layoutText(x, itemY - 2, text, SCR_H, 1.3f, [&](float rx, float ry, float rw, float rh)
+                       { listLayer.instances.push_back({rx, ry, rw, rh, textColor}); });
+        };
+        float dataX = listX + 12;
+        snprintf(label, sizeof(label), "%d", s->roll);
+        cell(dataX, label);
+        cell(dataX + 80, s->name.c_str());
+        cell(dataX + 320, s->department.c_str());
+        cell(dataX + 520, s->grade.c_str());
+        snprintf(label, sizeof(label), "%.2f", s->cgpa);
+        cell(dataX + 620, label);
+    }
+    listLayer.upload();
 }
 
 // Helper function to pad string to fixed width
@@ -394,16 +536,17 @@ void drawMessagePopup(const MessagePopup &popup, int SCR_W, int SCR_H, double cu
     drawRect(popupX, popupY, popupW, popupH, 0.15f, 0.7f, 0.15f, alpha);
     drawOutline(popupX, popupY, popupW, popupH, 0.2f, 0.9f, 0.2f);
 
-    // Center the text in the popup
+    // Center the text in the popup; text x is in 1.25px units
     float textScale = 2.0f;
-    float textX = popupX + 30;
+    float textX = (popupX + 100) * 0.8f;
     float textY = popupY + 40;
 
     drawText(textX, textY, popup.text, 1.0f, 1.0f, 1.0f, SCR_H, textScale, alpha);
 }
 
 // Draw details panel
-void drawDetailsPanel(const DetailsPanel &panel, int SCR_W, int SCR_H, double currentTime)
+// Ranks come from the local manager, so a connected client leaves them out
+void drawDetailsPanel(const DetailsPanel &panel, const StudentManager &manager, bool showRanks, int SCR_W, int SCR_H, double currentTime)
 {
     if (!panel.visible || !panel.currentStudent)
         return;
@@ -415,6 +558,7 @@ void drawDetailsPanel(const DetailsPanel &panel, int SCR_W, int SCR_H, double cu
     float panelH = SCR_H;
     float panelX = SCR_W - panelW * slideProgress;
     float panelY = 0;
+    float textX = (panelX + 187.5f) * 0.8f; // text x is in 1.25px units
 
     // Semi-transparent overlay
     drawRect(0, 0, SCR_W, SCR_H, 0, 0, 0, 0.3f * slideProgress);
@@ -425,13 +569,13 @@ void drawDetailsPanel(const DetailsPanel &panel, int SCR_W, int SCR_H, double cu
 
     // Panel header
     drawRect(panelX, SCR_H - 80, panelW, 80, 0.2f, 0.3f, 0.5f, 1.0f);
-    drawText(panelX + 20, SCR_H - 45, "Student Details", 1.0f, 1.0f, 1.0f, SCR_H, 2.0f);
+    drawText(textX, SCR_H - 45, "Student Details", 1.0f, 1.0f, 1.0f, SCR_H, 2.0f);
 
     // Close button (X)
     float closeX = panelX + panelW - 50;
     float closeY = SCR_H - 60;
     drawRect(closeX, closeY, 35, 35, 0.7f, 0.3f, 0.3f, 1.0f);
-    drawText(closeX + 10, closeY + 22, "X", 1.0f, 1.0f, 1.0f, SCR_H, 2.0f);
+    drawText((closeX + 10) * 0.8f, closeY + 22, "X", 1.0f, 1.0f, 1.0f, SCR_H, 2.0f);
 
     // Student details
     Student *s = panel.currentStudent;
@@ -439,44 +583,337 @@ void drawDetailsPanel(const DetailsPanel &panel, int SCR_W, int SCR_H, double cu
     float lineHeight = 70;
 
     // Name
-    drawText(panelX + 20, detailY, "Name:", 0.7f, 0.7f, 0.7f, SCR_H, 1.5f);
-    drawText(panelX + 20, detailY - 30, s->name, 1.0f, 1.0f, 1.0f, SCR_H, 1.7f);
+    drawText(textX, detailY, "Name:", 0.7f, 0.7f, 0.7f, SCR_H, 1.5f);
+    drawText(textX, detailY - 30, s->name, 1.0f, 1.0f, 1.0f, SCR_H, 1.7f);
     detailY -= lineHeight;
 
     // Roll
-    drawText(panelX + 20, detailY, "Roll Number:", 0.7f, 0.7f, 0.7f, SCR_H, 1.5f);
-    drawText(panelX + 20, detailY - 30, to_string(s->roll), 1.0f, 1.0f, 1.0f, SCR_H, 1.7f);
+    drawText(textX, detailY, "Roll Number:", 0.7f, 0.7f, 0.7f, SCR_H, 1.5f);
+    drawText(textX, detailY - 30, frameArena.format("%d", s->roll), 1.0f, 1.0f, 1.0f, SCR_H, 1.7f);
     detailY -= lineHeight;
 
     // Department
-    drawText(panelX + 20, detailY, "Department:", 0.7f, 0.7f, 0.7f, SCR_H, 1.5f);
-    drawText(panelX + 20, detailY - 30, s->department, 1.0f, 1.0f, 1.0f, SCR_H, 1.7f);
+    drawText(textX, detailY, "Department:", 0.7f, 0.7f, 0.7f, SCR_H, 1.5f);
+    drawText(textX, detailY - 30, s->department, 1.0f, 1.0f, 1.0f, SCR_H, 1.7f);
     detailY -= lineHeight;
 
     // Grade
-    drawText(panelX + 20, detailY, "Grade:", 0.7f, 0.7f, 0.7f, SCR_H, 1.5f);
-    drawText(panelX + 20, detailY - 30, s->grade, 1.0f, 1.0f, 1.0f, SCR_H, 1.7f);
+    drawText(textX, detailY, "Grade:", 0.7f, 0.7f, 0.7f, SCR_H, 1.5f);
+    drawText(textX, detailY - 30, s->grade, 1.0f, 1.0f, 1.0f, SCR_H, 1.7f);
     detailY -= lineHeight;
 
     // CGPA
-    drawText(panelX + 20, detailY, "CGPA:", 0.7f, 0.7f, 0.7f, SCR_H, 1.5f);
+    drawText(textX, detailY, "CGPA:", 0.7f, 0.7f, 0.7f, SCR_H, 1.5f);
     char cgpaStr[20];
     snprintf(cgpaStr, sizeof(cgpaStr), "%.2f / 4.00", s->cgpa);
-    drawText(panelX + 20, detailY - 30, string(cgpaStr), 1.0f, 1.0f, 1.0f, SCR_H, 1.7f);
+    drawText(textX, detailY - 30, cgpaStr, 1.0f, 1.0f, 1.0f, SCR_H, 1.7f);
+    detailY -= lineHeight;
+    if (!showRanks)
+        return;
+
+    // Rank (ties share a rank), answered by the Fenwick trees
+    char rankStr[48];
+    drawText(textX, detailY, "Overall Rank:", 0.7f, 0.7f, 0.7f, SCR_H, 1.5f);
+    snprintf(rankStr, sizeof(rankStr), "%llu / %llu", (unsigned long long)manager.ranks.overall.rankOf(s->cgpa),
+             (unsigned long long)manager.ranks.overall.total);
+    drawText(textX, detailY - 30, rankStr, 1.0f, 1.0f, 1.0f, SCR_H, 1.7f);
+    detailY -= lineHeight;
+
+    drawText(textX, detailY, "Department Rank:", 0.7f, 0.7f, 0.7f, SCR_H, 1.5f);
+    snprintf(rankStr, sizeof(rankStr), "%llu / %llu", (unsigned long long)manager.ranks.departmentRank(*s),
+             (unsigned long long)manager.ranks.departmentSize(s->department));
+    drawText(textX, detailY - 30, rankStr, 1.0f, 1.0f, 1.0f, SCR_H, 1.7f);
 }
 
+// Draw one aggregate row: label, headcount, mean and range, plus a mini histogram
+static void drawStatsRow(float panelX, float panelW, float y, const char *label, const GroupStats &g, int SCR_H)
+{
+    char line[96];
+    snprintf(line, sizeof(line), "%-8.8s %6llu  %.2f  %.2f-%.2f", label, (unsigned long long)g.count,
+             g.mean(), g.minCgpa(), g.maxCgpa());
+    drawText((panelX + 15) * 0.8f, y, line, 0.9f, 0.9f, 0.9f, SCR_H, 1.0f);
+
+    // drawText works in an 800-wide space, rects in window pixels
+    uint32_t peak = 1;
+    for (int i = 0; i < HISTOGRAM_BINS; ++i)
+        peak = max(peak, g.histogram[i]);
+    float barX = panelX + panelW - 15 - HISTOGRAM_BINS * 9;
+    for (int i = 0; i < HISTOGRAM_BINS; ++i)
+    {
+        float h = 14.0f * g.histogram[i] / peak;
+        drawRect(barX + i * 9, y - 14, 7, h, 0.3f, 0.6f, 0.9f);
+    }
+}
+
+// Draw statistics panel to the left of the details panel when both are open
+void drawStatsPanel(const StatsPanel &panel, const StudentManager &manager, bool detailsOpen, int SCR_W, int SCR_H, double currentTime)
+{
+    if (!panel.visible)
+        return;
+
+    float slideProgress = panel.getSlideProgress(currentTime);
+    float panelW = 380;
+    float rightEdge = detailsOpen ? SCR_W - 350.0f : (float)SCR_W;
+    float panelX = rightEdge - panelW * slideProgress;
+
+    drawRect(panelX - 10, 0, 10, SCR_H, 0, 0, 0, 0.5f * slideProgress);
+    drawRect(panelX, 0, panelW, SCR_H, 0.13f, 0.14f, 0.15f, 1.0f);
+
+    // Panel header
+    drawRect(panelX, SCR_H - 80, panelW, 80, 0.25f, 0.4f, 0.3f, 1.0f);
+    drawText((panelX + 20) * 0.8f, SCR_H - 45, "Statistics", 1.0f, 1.0f, 1.0f, SCR_H, 2.0f);
+
+    const RosterAggregates &agg = manager.aggregates;
+    float y = SCR_H - 110;
+    float lineHeight = 22;
+
+    drawText((panelX + 15) * 0.8f, y, "Group      Count  Mean  Range", 0.7f, 0.7f, 0.7f, SCR_H, 1.0f);
+    y -= lineHeight;
+    drawStatsRow(panelX, panelW, y, "All", agg.overall, SCR_H);
+    y -= lineHeight;
+
+    char pctStr[64];
+    const CgpaFenwick &ranks = manager.ranks.overall;
+    snprintf(pctStr, sizeof(pctStr), "p50 %.2f  p75 %.2f  p90 %.2f", ranks.percentile(0.5), ranks.percentile(0.75), ranks.percentile(0.9));
+    drawText((panelX + 15) * 0.8f, y, pctStr, 0.8f, 0.8f, 0.6f, SCR_H, 1.0f);
+    y -= lineHeight * 1.5f;
+
+    drawText((panelX + 15) * 0.8f, y, "By department", 0.7f, 0.8f, 0.7f, SCR_H, 1.2f);
+    y -= lineHeight;
+    for (auto &d : agg.byDepartment)
+    {
+        if (y < 200)
+            break;
+        drawStatsRow(panelX, panelW, y, d.first.empty() ? "-" : d.first.c_str(), d.second, SCR_H);
+        y -= lineHeight;
+    }
+    y -= lineHeight * 0.5f;
+
+    drawText((panelX + 15) * 0.8f, y, "By grade", 0.7f, 0.8f, 0.7f, SCR_H, 1.2f);
+    y -= lineHeight;
+    for (auto &g : agg.byGrade)
+    {
+        if (y < 20)
+            break;
+        drawStatsRow(panelX, panelW, y, g.first.empty() ? "-" : g.first.c_str(), g.second, SCR_H);
+        y -= lineHeight;
+    }
+}
+
+// Draw per-department top-N lists with an Export button in the header
+void drawLeaderboardPanel(const LeaderboardPanel &panel, bool detailsOpen, int SCR_W, int SCR_H, double currentTime)
+{
+    if (!panel.visible)
+        return;
+
+    float slideProgress = panel.getSlideProgress(currentTime);
+    float panelW = 380;
+    float rightEdge = detailsOpen ? SCR_W - 350.0f : (float)SCR_W;
+    float panelX = rightEdge - panelW * slideProgress;
+
+    drawRect(panelX - 10, 0, 10, SCR_H, 0, 0, 0, 0.5f * slideProgress);
+    drawRect(panelX, 0, panelW, SCR_H, 0.13f, 0.14f, 0.15f, 1.0f);
+
+    // Panel header with export button
+    drawRect(panelX, SCR_H - 80, panelW, 80, 0.45f, 0.35f, 0.15f, 1.0f);
+    drawText((panelX + 20) * 0.8f, SCR_H - 45, "Top 10", 1.0f, 1.0f, 1.0f, SCR_H, 2.0f);
+    drawRect(panelX + panelW - 110, SCR_H - 60, 90, 35, 0.3f, 0.5f, 0.3f, 1.0f);
+    drawText((panelX + panelW - 100) * 0.8f, SCR_H - 38, "Export", 1.0f, 1.0f, 1.0f, SCR_H, 1.3f);
+
+    float y = SCR_H - 105;
+    float lineHeight = 15;
+    for (auto &board : panel.boards)
+    {
+        if (y < 40)
+            break;
+        drawText((panelX + 15) * 0.8f, y, board.first.empty() ? "-" : board.first.c_str(), 0.8f, 0.9f, 0.6f, SCR_H, 1.2f);
+        y -= lineHeight + 4;
+        int rank = 1;
+        for (auto &e : board.second)
+        {
+            if (y < 20)
+                break;
+            char line[96];
+            snprintf(line, sizeof(line), "%2d. %-18.18s %8d  %.2f", rank++, e.name.c_str(), e.roll, e.cgpa);
+            drawText((panelX + 15) * 0.8f, y, line, 0.9f, 0.9f, 0.9f, SCR_H, 1.0f);
+            y -= lineHeight;
+        }
+        y -= 6;
+    }
+}
+
+// Where the F3 overlay sits, bottom left
+static const float PROFILER_X = 20, PROFILER_Y = 20, PROFILER_W = FrameProfiler::HISTORY + 20, PROFILER_H = 278;
+
+// Frame-time graph of the recorded frames plus p50/p95/p99 per phase
+void drawProfilerOverlay(const FrameProfiler &prof, int SCR_H)
+{
+    float boxX = PROFILER_X, boxY = PROFILER_Y, boxW = PROFILER_W, boxH = PROFILER_H;
+    drawRect(boxX, boxY, boxW, boxH, 0, 0, 0, 0.75f);
+
+    // One bar per frame, newest on the right, scaled so 33 ms fills the graph
+    float graphX = boxX + 10, graphY = boxY + 10, graphH = 70, scaleMs = 33.3f;
+    uint32_t barColor = UiRenderer::packColor(0.3f, 0.8f, 0.4f, 0.9f);
+    for (int i = 0; i < prof.count; ++i)
+    {
+        float ms = prof.frame(i)[(int)FramePhase::FRAME];
+        float h = min(graphH, graphH * ms / scaleMs);
+        renderer.rect(graphX + FrameProfiler::HISTORY - 1 - i, graphY, 1, h, barColor);
+    }
+    // 60 Hz budget line
+    drawRect(graphX, graphY + graphH * 16.7f / scaleMs, FrameProfiler::HISTORY, 1, 0.9f, 0.3f, 0.3f, 0.8f);
+
+    float textX = (boxX + 10) * 0.8f;
+    float y = boxY + boxH - 12;
+    drawText(textX, y, "phase      p50     p95     p99 ms   (F3 hides)", 0.8f, 0.8f, 0.8f, SCR_H, 1.0f);
+    for (int phase = 0; phase < FrameProfiler::PHASES; ++phase)
+    {
+        y -= 16;
+        float p50, p95, p99;
+        prof.percentiles(phase, p50, p95, p99);
+        char line[96];
+        snprintf(line, sizeof(line), "%-6s %7.2f %7.2f %7.2f", FrameProfiler::phaseName(phase), p50, p95, p99);
+        drawText(textX, y, line, 0.9f, 0.9f, 0.9f, SCR_H, 1.0f);
+    }
+
+    // First input event of a frame until its swap finished
+    float p50, p95, p99;
+    prof.latencyPercentiles(p50, p95, p99);
+    char line[96];
+    snprintf(line, sizeof(line), "in->sw %7.2f %7.2f %7.2f", p50, p95, p99);
+    y -= 16;
+    drawText(textX, y, line, 0.7f, 0.85f, 1.0f, SCR_H, 1.0f);
+
+    // Heap allocations per frame; a frame where nothing changed should show 0
+    uint32_t last = prof.count ? prof.frameAllocations(0) : 0, peak = 0;
+    for (int i = 0; i < prof.count; ++i)
+        peak = max(peak, prof.frameAllocations(i));
+    snprintf(line, sizeof(line), "allocs/frame %5u  max %5u  total %llu", last, peak, (unsigned long long)AllocStats::count());
+    y -= 16;
+    drawText(textX, y, line, last ? 1.0f : 0.6f, last ? 0.5f : 0.9f, last ? 0.4f : 0.6f, SCR_H, 1.0f);
+
+    // What the previous frame sent to the GPU
+    snprintf(line, sizeof(line), "draw calls %d  vertices %zu  instances %zu  list uploads %llu", renderer.lastDrawCalls,
+             renderer.lastVertexCount, renderer.lastInstanceCount, (unsigned long long)listLayer.uploads);
+    y -= 16;
+    drawText(textX, y, line, 0.6f, 0.9f, 0.6f, SCR_H, 1.0f);
+
+    // How the list cache served its frames
+    snprintf(line, sizeof(line), "list cache  full %llu  strips %llu  reused %llu", (unsigned long long)listCache.fullRedraws,
+             (unsigned long long)listCache.stripRedraws, (unsigned long long)listCache.reuses);
+    y -= 16;
+    drawText(textX, y, line, 0.6f, 0.9f, 0.6f, SCR_H, 1.0f);
+
+    // How much of the window the previous frame drew again
+    snprintf(line, sizeof(line), "redrawn %d rects  %.1f%% of window", damage.lastCount,
+             100.0 * damage.lastPixels / ((double)backing.width * backing.height));
+    y -= 16;
+    drawText(textX, y, line, 0.6f, 0.9f, 0.6f, SCR_H, 1.0f);
+}
+
+// Drives the UI through its idle states (plain list, stats panel, leaderboard
+// with details open, all with the F3 overlay) and counts heap allocations in
+// the frames after each state has settled. Any allocation fails the check.
+class AllocCheck
+{
+public:
+    static constexpr int WARMUP_FRAMES = 30;
+    static constexpr int MEASURED_FRAMES = 60;
+    static constexpr int STAGES = 3;
+
+    bool active = false;
+    int frame = 0;
+    uint64_t stageStart = 0;
+    uint64_t allocations[STAGES] = {};
+
+    int stage() const { return frame / (WARMUP_FRAMES + MEASURED_FRAMES); }
+    int frameInStage() const { return frame % (WARMUP_FRAMES + MEASURED_FRAMES); }
+    bool done() const { return stage() >= STAGES; }
+
+    uint64_t total() const
+    {
+        uint64_t sum = 0;
+        for (uint64_t a : allocations)
+            sum += a;
+        return sum;
+    }
+};
+
 // ------------------------- Main -------------------------
-int main()
+// main [--trace [file]]        start with tracing on; F4 toggles it, F5 writes the file
+//      [--check-allocs]        exit 1 if a steady-state frame allocates (see AllocCheck)
+//      [--record file]         log every frame's clock and input events to file
+//      [--replay file]         replay a recording in a hidden window and print frame times
+//      [--replay-json file]    also write the replay's frame times as JSON
+//      [--connect [socket]]    use a running roster_server instead of students.txt
+int main(int argc, char **argv)
 {
+    string tracePath = "trace.json";
+    string recordPath, replayPath, replayJsonPath, connectPath;
+    AllocCheck allocCheck;
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc && argv[i + 1][0] != '-';
+        if (arg == "--trace")
+        {
+            Trace::setEnabled(true);
+            if (hasValue)
+                tracePath = argv[++i];
+        }
+        else if (arg == "--check-allocs")
+            allocCheck.active = true;
+        else if (arg == "--record" && hasValue)
+            recordPath = argv[++i];
+        else if (arg == "--replay" && hasValue)
+            replayPath = argv[++i];
+        else if (arg == "--replay-json" && hasValue)
+            replayJsonPath = argv[++i];
+        else if (arg == "--connect")
+            connectPath = hasValue ? argv[++i] : DEFAULT_SOCKET;
+    }
+
+    // Replays run on the recorded clock against a scratch copy of the recorded
+    // roster, so Save/Delete in the session never touch students.txt
+    string dataPath = "students.txt";
+    InputReplay replay;
+    bool replaying = !replayPath.empty();
+    if (replaying)
+    {
+        if (!replay.load(replayPath))
+        {
+            cerr << replay.error << "\n";
+            return 2;
+        }
+        dataPath = replayPath + ".replay.txt";
+    }
+    // A recording replays against a local roster, and a connected GUI holds
+    // only a page of the server's
+    if (!recordPath.empty() && !connectPath.empty() && !replaying)
+    {
+        cerr << "--record cannot be used with --connect\n";
+        return 2;
+    }
+
     if (!glfwInit())
     {
         cerr << "GLFW init failed\n";
         return -1;
     }
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 2);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
-
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifdef __APPLE__
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GLFW_TRUE);
+#endif
+    if (replaying)
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    // Where screen coordinates are pixels, open at 1000x700 logical pixels
+    glfwWindowHint(GLFW_SCALE_TO_MONITOR, GLFW_TRUE);
+
+    // The window's size in logical pixels, as of the last layout pass
     int SCR_W = 1000, SCR_H = 700;
+    WindowMetrics metrics;
     GLFWwindow *window = glfwCreateWindow(SCR_W, SCR_H, "Student Management 2D GUI", NULL, NULL);
     if (!window)
     {
@@ -485,81 +922,297 @@ int main()
         return -1;
     }
     glfwMakeContextCurrent(window);
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        cerr << "Could not load OpenGL 3.3\n";
+        glfwTerminate();
+        return -1;
+    }
+    if (!renderer.init())
+    {
+        cerr << "Renderer init failed: " << renderer.error << "\n";
+        glfwTerminate();
+        return -1;
+    }
+    renderer.createInstances(listLayer);
+
+    // A replay takes its input from the recording only, and renders unthrottled
+    if (replaying)
+        glfwSwapInterval(0);
+    else
+    {
+        glfwSetCursorPosCallback(window, cursor_cb);
+        glfwSetMouseButtonCallback(window, mouse_cb);
+        glfwSetKeyCallback(window, key_cb);
+        glfwSetCharCallback(window, char_cb);
+        glfwSetScrollCallback(window, scroll_cb);
+    }
+    glfwSetFramebufferSizeCallback(window, framebuffer_size_cb);
+    glfwSetWindowContentScaleCallback(window, content_scale_cb);
 
-    glfwSetCursorPosCallback(window, cursor_cb);
-    glfwSetMouseButtonCallback(window, mouse_cb);
-    glfwSetKeyCallback(window, key_cb);
-    glfwSetCharCallback(window, char_cb);
-
-    glViewport(0, 0, SCR_W, SCR_H);
-    glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
-    glOrtho(0, SCR_W, 0, SCR_H, -1, 1);
-    glMatrixMode(GL_MODELVIEW);
-    glLoadIdentity();
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    // ------------------------- UI Elements (FIXED POSITIONS) -------------------------
-    // Buttons positioned 20px from top (in bottom-left coordinate system: SCR_H - 20 - 40)
-    float btnY = (float)SCR_H - 60.0f; // 20px margin from top, 40px button height
-    Button btnAdd{20.0f, btnY, 100.0f, 40.0f, "Add"};
-    Button btnEdit{140.0f, btnY, 100.0f, 40.0f, "Edit"};
-    Button btnDelete{260.0f, btnY, 100.0f, 40.0f, "Delete"};
-    Button btnSave{380.0f, btnY, 100.0f, 40.0f, "Save"};
-    Button btnLoad{500.0f, btnY, 100.0f, 40.0f, "Load"};
+    // ------------------------- UI Elements -------------------------
+    // Positions from the left are fixed; heights from the top and the search
+    // box width are set by the layout pass below
+    Button btnAdd{20.0f, 0.0f, 100.0f, 40.0f, "Add"};
+    Button btnEdit{140.0f, 0.0f, 100.0f, 40.0f, "Edit"};
+    Button btnDelete{260.0f, 0.0f, 100.0f, 40.0f, "Delete"};
+    Button btnSave{380.0f, 0.0f, 100.0f, 40.0f, "Save"};
+    Button btnLoad{500.0f, 0.0f, 100.0f, 40.0f, "Load"};
+    Button btnStats{620.0f, 0.0f, 100.0f, 40.0f, "Stats"};
+    Button btnTop{740.0f, 0.0f, 100.0f, 40.0f, "Top 10"};
 
     // First row of input boxes
-    float inputY1 = (float)SCR_H - 110.0f; // 70px from top (20px margin + 40px button + 10px gap)
-    InputBox inputName{20.0f, inputY1, 200.0f, 35.0f, "", false};
-    InputBox inputRoll{230.0f, inputY1, 100.0f, 35.0f, "", false};
-    InputBox inputGrade{340.0f, inputY1, 100.0f, 35.0f, "", false};
-    InputBox inputSearch{450.0f, inputY1, 510.0f, 35.0f, "", false};
+    InputBox inputName{20.0f, 0.0f, 200.0f, 35.0f, "", false};
+    InputBox inputRoll{230.0f, 0.0f, 100.0f, 35.0f, "", false};
+    InputBox inputGrade{340.0f, 0.0f, 100.0f, 35.0f, "", false};
+    InputBox inputSearch{450.0f, 0.0f, 510.0f, 35.0f, "", false};
 
     // Second row of input boxes
-    float inputY2 = (float)SCR_H - 155.0f; // 45px below first row
-    InputBox inputDepartment{20.0f, inputY2, 200.0f, 35.0f, "", false};
-    InputBox inputCGPA{230.0f, inputY2, 100.0f, 35.0f, "", false};
+    InputBox inputDepartment{20.0f, 0.0f, 200.0f, 35.0f, "", false};
+    InputBox inputCGPA{230.0f, 0.0f, 100.0f, 35.0f, "", false};
+
+    Button *buttons[] = {&btnAdd, &btnEdit, &btnDelete, &btnSave, &btnLoad, &btnStats, &btnTop};
+    InputBox *inputBoxes[] = {&inputName, &inputRoll, &inputGrade, &inputSearch, &inputDepartment, &inputCGPA};
 
+    // Connected to a server, the GUI holds only the page of rows it draws;
+    // the server owns the roster and writes it back to disk
     StudentManager manager;
-    manager.load();
+    RosterClient client;
+    bool remote = !connectPath.empty() && !replaying;
+    if (remote)
+    {
+        if (!client.connect(connectPath) || !client.subscribe())
+        {
+            cerr << client.error << "\n";
+            glfwTerminate();
+            return 2;
+        }
+    }
+    else if (replaying)
+    {
+        manager.load(replay.rosterPath);
+        manager.save(dataPath);
+    }
+    else
+        manager.load(dataPath);
+
+    InputRecorder recorder;
+    if (!recordPath.empty())
+    {
+        // The recording starts from a snapshot of the roster as it is now
+        string rosterPath = recordPath + ".students.txt";
+        manager.save(rosterPath);
+        if (!recorder.open(recordPath, rosterPath))
+            cerr << "Could not open " << recordPath << " for recording\n";
+    }
     Student *selected = nullptr;
-    float scrollOffset = 0.0f;
+    KineticScroll scroll;
     vector<int> selectedRolls; // Track selected student rolls for deletion
 
+    // Bumped whenever the rows in `visible` or their selection change; the
+    // list layer is rebuilt when it no longer matches
+    uint64_t listVersion = 0, listLayerVersion = ~0ULL, listCacheVersion = ~0ULL;
+    size_t listLayerFirst = 0, listLayerEnd = 0;
+
     // Message popup
     MessagePopup messagePopup;
 
     // Details panel
     DetailsPanel detailsPanel;
 
+    // Statistics panel
+    StatsPanel statsPanel;
+
+    // Leaderboard panel
+    LeaderboardPanel leaderboardPanel;
+
+    // Query results for the search box
+    vector<Student *> visible;
+    QueryPlan queryPlan;
+    string lastQuery;
+    uint64_t lastQueryVersion = ~0ULL;
+    vector<Student> remoteRows; // the server's rows backing `visible` when connected
+    Student detailsCopy;        // details panel row when connected; remoteRows is replaced on refresh
+    bool remoteStale = true;    // re-query rather than apply change-feed deltas
+    uint64_t appliedSeq = 0;    // newest server change reflected in remoteRows
+    vector<RowChange> remoteChanges;
+    // Connected, only the rows around the screen are fetched: a page either
+    // side of it, starting at match `remoteFirst`
+    size_t remoteFirst = 0, remoteLimit = 0;
+
+    // List geometry, from the layout pass
+    float listX = 20, listTop = 0, listW = 0, listH = 0;
+    float listRowsH = 0;  // list height between the header and the bottom edge
+    size_t pageSize = 0;  // rows the list shows at once
+    size_t pageRows = 0;  // rows from the list's top to the window's bottom
+
+    // Everything that depends on the window size, worked out when it or the
+    // pixel density changes rather than every frame. Widgets keep their
+    // distance from the top left; the search box and the list take up the
+    // rest of the width, and the list the rest of the height.
+    auto layOut = [&]()
+    {
+        SCR_W = (int)ceil(metrics.width);
+        SCR_H = (int)ceil(metrics.height);
+        glViewport(0, 0, metrics.framebufferW, metrics.framebufferH);
+        renderer.setProjection(metrics.width, metrics.height, metrics.scale);
+        damage.scale = metrics.scale;
+        glfwSetWindowSizeLimits(window, (int)ceil(WindowMetrics::MIN_W / metrics.cursorScale),
+                                (int)ceil(WindowMetrics::MIN_H / metrics.cursorScale), GLFW_DONT_CARE, GLFW_DONT_CARE);
+
+        for (Button *btn : buttons)
+            btn->y = SCR_H - 60.0f; // 20px margin from top, 40px button height
+        inputName.y = inputRoll.y = inputGrade.y = inputSearch.y = SCR_H - 110.0f; // 10px below the buttons
+        inputDepartment.y = inputCGPA.y = SCR_H - 155.0f; // 45px below the first row
+        inputSearch.w = SCR_W - 40 - inputSearch.x;
+
+        listTop = SCR_H - 225;
+        listW = SCR_W - 40;
+        listH = SCR_H - 245;
+        listRowsH = SCR_H - 293.0f;
+        pageSize = (size_t)((SCR_H - 225 - 80) / 24) + 1;
+        pageRows = (size_t)(listTop / 24) + 1;
+        remoteLimit = 3 * pageSize;
+
+        // New pixel sizes for the stores; the list layer is laid out
+        // against listTop, so it is built again too
+        renderer.resizeBacking(backing, metrics.framebufferW, metrics.framebufferH);
+        renderer.resizeCache(listCache, renderer.toPixels(listW - 1), renderer.toPixels(listTop - 68));
+        backing.valid = listCache.valid = false;
+        listLayerVersion = listCacheVersion = ~0ULL;
+    };
+
+    // Pointer position and last click, as of the events consumed so far
+    double mouseX = 0, mouseY = 0;
+    double lastClickTime = -1.0;
+
+    // What the backing store shows, beyond what the elements track themselves
+    int drawnSortKey = -1;
+    bool profilerDrawn = false;
+
+    // F3 shows the overlay; replays and the allocation check profile regardless
+    bool showProfiler = allocCheck.active;
+    profiler.setEnabled(showProfiler || replaying);
+    ReplayReport replayReport;
+    replayReport.reserve(replay.frames.size());
+    auto replayStart = chrono::steady_clock::now();
+
     while (!glfwWindowShouldClose(window))
     {
+        TraceSpan frameSpan("frame", "frame");
+        profiler.beginFrame();
+        frameArena.reset();
+        ProfileScope inputScope(profiler, FramePhase::INPUT);
         glfwPollEvents();
 
-        double currentTime = glfwGetTime();
+        if (replaying && replay.done())
+            break;
+        double currentTime = replaying ? replay.advance(inputQueue) : glfwGetTime();
+        recorder.frame(currentTime);
+        if (replaying && replay.hasLayouts())
+        {
+            // Lay out when and at the size the recorded session did, so
+            // recorded clicks land on the same widgets
+            if (const RecordedLayout *l = replay.layout())
+            {
+                metrics.apply(*l);
+                glfwSetWindowSize(window, (int)lround(l->framebufferW / l->scale / l->cursorScale),
+                                  (int)lround(l->framebufferH / l->scale / l->cursorScale));
+                layOut();
+            }
+        }
+        else if (layoutStale && metrics.read(window))
+        {
+            layOut();
+            layoutStale = false;
+            recorder.layout(metrics.recorded());
+        }
 
-        // Mouse conversion (top-left origin to bottom-left)
-        double mx = mouseX, my = mouseY;
-        my = SCR_H - my;
-        bool click = false;
-        bool doubleClick = false;
-        if (mouseJustPressed)
+        // Re-run the query only when it or the data changed; row clicks need it current
+        auto refreshVisible = [&]()
         {
-            click = true;
-            mouseJustPressed = false;
+            // A new search starts at the top
+            if (inputSearch.text != lastQuery)
+            {
+                scroll.reset();
+                remoteFirst = 0;
+            }
+            if (remote)
+            {
+                if (inputSearch.text == lastQuery && !remoteStale)
+                    return;
+                queryPlan = QueryPlan();
+                queryPlan.plan = "server";
+                if (!client.query(inputSearch.text, (uint32_t)remoteFirst, (uint32_t)remoteLimit, remoteRows, queryPlan.matches,
+                                  &queryPlan.error))
+                    queryPlan.error = client.error;
+                visible.clear();
+                for (auto &s : remoteRows)
+                    visible.push_back(&s);
+                ++listVersion;
+                lastQuery = inputSearch.text;
+                appliedSeq = client.resultSeq;
+                remoteStale = false;
+                return;
+            }
+            if (inputSearch.text != lastQuery || manager.version != lastQueryVersion)
+            {
+                visible = manager.query(inputSearch.text, &queryPlan);
+                ++listVersion;
+                lastQuery = inputSearch.text;
+                lastQueryVersion = manager.version;
+            }
+        };
 
-            // Check for double click
-            if (currentTime - lastClickTime <= DOUBLE_CLICK_TIME)
+        // Patch the page from the server's change feed. With no search text the
+        // page is a run of rows in server order: edits land in place and new
+        // rows at the end. Anything that could reorder or refilter it re-queries.
+        auto applyRemoteChanges = [&]()
+        {
+            bool complete = false;
+            if (!client.changes(appliedSeq, remoteChanges, complete))
             {
-                doubleClick = true;
+                messagePopup.show(client.error, currentTime);
+                return;
             }
-            lastClickTime = currentTime;
-        }
+            for (auto &c : remoteChanges)
+            {
+                if (detailsPanel.visible && detailsCopy.roll == c.row.roll)
+                {
+                    if (c.kind == RowChange::UPSERT)
+                    {
+                        detailsCopy = c.row;
+                        detailsPanel.dirty = true;
+                    }
+                    else
+                        detailsPanel.hide();
+                }
+                auto onPage = find_if(remoteRows.begin(), remoteRows.end(), [&](const Student &s)
+                                      { return s.roll == c.row.roll; });
+                if (!inputSearch.text.empty())
+                    remoteStale = true; // the row may have entered or left the matches
+                else if (onPage == remoteRows.end())
+                    remoteStale |= c.kind == RowChange::UPSERT && remoteRows.size() < remoteLimit;
+                else if (c.kind == RowChange::REMOVE)
+                    remoteStale = true;
+                else
+                {
+                    *onPage = c.row;
+                    ++listVersion;
+                }
+            }
+            remoteStale |= !complete;
+            appliedSeq = client.serverSeq;
+        };
 
-        // Handle clicks
-        if (click)
+        // One left click at (mx, my), bottom-left origin
+        auto handleClick = [&](double mx, double my, bool doubleClick)
         {
+            bool click = true;
+
             // Check if clicking close button on details panel
             if (detailsPanel.visible)
             {
@@ -581,6 +1234,22 @@ int main()
                 }
             }
 
+            // Side panel (stats or leaderboard) consumes clicks inside it
+            if (click && (statsPanel.visible || leaderboardPanel.visible))
+            {
+                float panelW = 380;
+                float panelX = (detailsPanel.visible ? SCR_W - 350.0f : (float)SCR_W) - panelW;
+                if (mx >= panelX && mx <= panelX + panelW)
+                {
+                    if (leaderboardPanel.visible && pointInRect((float)mx, (float)my, panelX + panelW - 110, SCR_H - 60, 90, 35))
+                    {
+                        manager.exportLeaderboards();
+                        messagePopup.show("Leaderboard exported!", currentTime);
+                    }
+                    click = false;
+                }
+            }
+
             if (click) // Only process other clicks if not consumed by panel
             {
                 inputName.focused = pointInRect((float)mx, (float)my, inputName.x, inputName.y, inputName.w, inputName.h);
@@ -591,15 +1260,14 @@ int main()
                 inputCGPA.focused = pointInRect((float)mx, (float)my, inputCGPA.x, inputCGPA.y, inputCGPA.w, inputCGPA.h);
 
                 // Check for column header clicks for sorting
-                float listX = 20, listTop = SCR_H - 225;
                 float headerX = listX + 10;
                 float headerY = listTop - 20;
                 float headerH = 25;
 
-                bool headerClicked = false;
+                bool headerClicked = remote; // the server's order is fixed
 
                 // Check columns from right to left with exact boundaries
-                if (pointInRect((float)mx, (float)my, headerX + 620, headerY - headerH, 150, headerH))
+                if (!headerClicked && pointInRect((float)mx, (float)my, headerX + 620, headerY - headerH, 150, headerH))
                 {
                     // CGPA column clicked (rightmost)
                     manager.sortBy(SortColumn::CGPA);
@@ -661,7 +1329,19 @@ int main()
                     }
                     if (!inputName.text.empty() && roll >= 0)
                     {
-                        manager.add({inputName.text, roll, inputGrade.text, inputDepartment.text, cgpa});
+                        Student s{inputName.text, roll, inputGrade.text, inputDepartment.text, cgpa};
+                        if (remote && !client.put({s}))
+                        {
+                            messagePopup.show(client.error, currentTime);
+                            return;
+                        }
+                        if (!remote && !manager.add(s))
+                        {
+                            messagePopup.show("Roll number already exists!", currentTime);
+                            return;
+                        }
+                        if (remote)
+                            remoteStale = true;
                         inputName.text.clear();
                         inputRoll.text.clear();
                         inputGrade.text.clear();
@@ -688,24 +1368,40 @@ int main()
                     }
                     if (roll >= 0)
                     {
-                        Student *s = manager.findByRoll(roll);
+                        vector<Student> fetched;
+                        vector<uint8_t> found;
+                        Student *s = nullptr;
+                        if (!remote)
+                            s = manager.findByRoll(roll);
+                        else if (client.get({roll}, fetched, found) && found[0])
+                            s = &fetched[0];
                         if (s)
                         {
-                            s->name = inputName.text;
-                            s->grade = inputGrade.text;
-                            s->department = inputDepartment.text;
+                            Student updated = *s;
+                            updated.name = inputName.text;
+                            updated.grade = inputGrade.text;
+                            updated.department = inputDepartment.text;
                             try
                             {
-                                s->cgpa = stof(inputCGPA.text);
-                                if (s->cgpa > 4.0f)
-                                    s->cgpa = 4.0f;
-                                if (s->cgpa < 0.0f)
-                                    s->cgpa = 0.0f;
+                                updated.cgpa = stof(inputCGPA.text);
+                                if (updated.cgpa > 4.0f)
+                                    updated.cgpa = 4.0f;
+                                if (updated.cgpa < 0.0f)
+                                    updated.cgpa = 0.0f;
                             }
                             catch (...)
                             {
-                                s->cgpa = 0.0f;
+                                updated.cgpa = 0.0f;
+                            }
+                            if (remote && !client.put({updated}))
+                            {
+                                messagePopup.show(client.error, currentTime);
+                                return;
                             }
+                            if (remote)
+                                remoteStale = true;
+                            else
+                                manager.update(s, updated);
 
                             // Show success message
                             messagePopup.show("Student updated successfully!", currentTime);
@@ -724,14 +1420,17 @@ int main()
                     if (!selectedRolls.empty())
                     {
                         deleteCount = selectedRolls.size();
-                        for (int roll : selectedRolls)
+                        if (remote)
+                            deleted = client.remove(selectedRolls) >= 0;
+                        else
                         {
-                            manager.removeByRoll(roll);
+                            manager.removeRolls(selectedRolls);
+                            // AUTO-SAVE: Save to file after deletion
+                            manager.save(dataPath);
+                            deleted = true;
                         }
                         selectedRolls.clear();
-                        // AUTO-SAVE: Save to file after deletion
-                        manager.save();
-                        deleted = true;
+                        ++listVersion;
                     }
                     else
                     {
@@ -745,15 +1444,23 @@ int main()
                         {
                             roll = -1;
                         }
-                        if (roll >= 0)
+                        if (roll >= 0 && remote)
+                        {
+                            deleteCount = 1;
+                            deleted = client.remove({roll}) >= 0;
+                        }
+                        else if (roll >= 0)
                         {
                             manager.removeByRoll(roll);
                             // AUTO-SAVE: Save to file after deletion
-                            manager.save();
+                            manager.save(dataPath);
                             deleteCount = 1;
                             deleted = true;
                         }
                     }
+                    if (remote && !deleted && deleteCount > 0)
+                        messagePopup.show(client.error, currentTime);
+                    remoteStale |= remote && deleted;
 
                     // Show success message
                     if (deleted)
@@ -769,323 +1476,579 @@ int main()
                     btnSave.pressed = true;
                     btnSave.pressTime = currentTime;
 
-                    manager.save();
-                    // Show success message
-                    messagePopup.show("Students saved successfully!", currentTime);
+                    if (remote)
+                        messagePopup.show("The server saves changes automatically", currentTime);
+                    else
+                    {
+                        manager.save(dataPath);
+                        // Show success message
+                        messagePopup.show("Students saved successfully!", currentTime);
+                    }
                 }
                 else if (hit(btnLoad))
                 {
                     btnLoad.pressed = true;
                     btnLoad.pressTime = currentTime;
 
-                    manager.load();
+                    if (remote)
+                        remoteStale = true; // fetch the page again
+                    else
+                        manager.load(dataPath);
                     // Show success message
                     messagePopup.show("Students loaded successfully!", currentTime);
                 }
+                else if (hit(btnStats))
+                {
+                    btnStats.pressed = true;
+                    btnStats.pressTime = currentTime;
+
+                    if (remote)
+                        messagePopup.show("Stats are not available when connected", currentTime);
+                    else
+                        statsPanel.toggle(currentTime);
+                    leaderboardPanel.visible = false;
+                }
+                else if (hit(btnTop))
+                {
+                    btnTop.pressed = true;
+                    btnTop.pressTime = currentTime;
+
+                    if (remote)
+                        messagePopup.show("Top 10 is not available when connected", currentTime);
+                    else
+                        leaderboardPanel.toggle(currentTime);
+                    statsPanel.visible = false;
+                }
             }
-        }
 
-        // Keyboard input
-        if (!textInputBuffer.empty())
+            refreshVisible();
+
+            // The row under the click. Rows are 20px tall on a 24px pitch, so
+            // its index follows from the position without walking the list.
+            Student *row = nullptr;
+            double ystart = listTop - 50 + scroll.offset;
+            double below = ystart + 2 - my; // from the top of row 0 down to the click
+            if ((click || doubleClick) && below >= 0 && mx >= listX + 5 && mx <= listX + listW - 5)
+            {
+                size_t idx = (size_t)(below / 24);
+                double itemY = ystart - 24.0 * idx;
+                size_t first = remote ? remoteFirst : 0;
+                if (my >= itemY - 18 && itemY > 30 && itemY < listTop - 30 && idx >= first && idx - first < visible.size())
+                    row = visible[idx - first];
+            }
+
+            // Handle row clicks for both selection (double-click) and details view (single click)
+            if (click && row)
+            {
+                // Single click - show details panel
+                Student *s = row;
+                if (remote)
+                {
+                    detailsCopy = *s;
+                    s = &detailsCopy;
+                }
+                detailsPanel.show(s, currentTime);
+            }
+
+            // Handle row selection with double-click
+            if (doubleClick && row)
+            {
+                // Toggle selection
+                auto it = find(selectedRolls.begin(), selectedRolls.end(), row->roll);
+                if (it != selectedRolls.end())
+                {
+                    // Already selected, deselect it
+                    selectedRolls.erase(it);
+                }
+                else
+                {
+                    // Not selected, select it
+                    selectedRolls.push_back(row->roll);
+                }
+                ++listVersion;
+            }
+        };
+
+        // Text typed into whichever box has focus
+        auto handleChar = [&](unsigned int cp)
         {
+            if (cp < 32 || cp >= 128)
+                return;
+            char c = (char)cp;
             if (inputName.focused)
-                inputName.text += textInputBuffer;
+                inputName.text.push_back(c);
             else if (inputRoll.focused)
             {
-                for (char c : textInputBuffer)
-                    if (isdigit(c) || c == '-')
-                        inputRoll.text.push_back(c);
+                if (isdigit(c) || c == '-')
+                    inputRoll.text.push_back(c);
             }
             else if (inputGrade.focused)
-                inputGrade.text += textInputBuffer;
+                inputGrade.text.push_back(c);
             else if (inputSearch.focused)
-                inputSearch.text += textInputBuffer;
+                inputSearch.text.push_back(c);
             else if (inputDepartment.focused)
-                inputDepartment.text += textInputBuffer;
+                inputDepartment.text.push_back(c);
             else if (inputCGPA.focused)
             {
-                for (char c : textInputBuffer)
-                    if (isdigit(c) || c == '.')
-                        inputCGPA.text.push_back(c);
+                if (isdigit(c) || c == '.')
+                    inputCGPA.text.push_back(c);
             }
-            textInputBuffer.clear();
-        }
+        };
 
-        if (keysDown[GLFW_KEY_BACKSPACE])
+        // Key presses; returns false when ESC should close the window
+        auto handleKey = [&](int key) -> bool
         {
-            if (inputName.focused && !inputName.text.empty())
-                inputName.text.pop_back();
-            else if (inputRoll.focused && !inputRoll.text.empty())
-                inputRoll.text.pop_back();
-            else if (inputGrade.focused && !inputGrade.text.empty())
-                inputGrade.text.pop_back();
-            else if (inputSearch.focused && !inputSearch.text.empty())
-                inputSearch.text.pop_back();
-            else if (inputDepartment.focused && !inputDepartment.text.empty())
-                inputDepartment.text.pop_back();
-            else if (inputCGPA.focused && !inputCGPA.text.empty())
-                inputCGPA.text.pop_back();
-            keysDown[GLFW_KEY_BACKSPACE] = false;
-        }
-        if (keysDown[GLFW_KEY_ESCAPE])
-        {
-            if (detailsPanel.visible)
+            if (key == GLFW_KEY_BACKSPACE)
             {
-                detailsPanel.hide();
-                keysDown[GLFW_KEY_ESCAPE] = false;
+                if (inputName.focused && !inputName.text.empty())
+                    inputName.text.pop_back();
+                else if (inputRoll.focused && !inputRoll.text.empty())
+                    inputRoll.text.pop_back();
+                else if (inputGrade.focused && !inputGrade.text.empty())
+                    inputGrade.text.pop_back();
+                else if (inputSearch.focused && !inputSearch.text.empty())
+                    inputSearch.text.pop_back();
+                else if (inputDepartment.focused && !inputDepartment.text.empty())
+                    inputDepartment.text.pop_back();
+                else if (inputCGPA.focused && !inputCGPA.text.empty())
+                    inputCGPA.text.pop_back();
             }
-            else
+            else if (key == GLFW_KEY_ESCAPE)
             {
-                break;
+                if (detailsPanel.visible)
+                    detailsPanel.hide();
+                else if (statsPanel.visible || leaderboardPanel.visible)
+                {
+                    statsPanel.visible = false;
+                    leaderboardPanel.visible = false;
+                }
+                else
+                    return false;
             }
-        }
+            else if (key == GLFW_KEY_F3)
+            {
+                showProfiler = !showProfiler;
+                profiler.setEnabled(showProfiler || replaying);
+            }
+            else if (key == GLFW_KEY_F4)
+            {
+                Trace::setEnabled(!Trace::on());
+                messagePopup.show(Trace::on() ? "Tracing started" : "Tracing paused", currentTime);
+            }
+            else if (key == GLFW_KEY_F5)
+                messagePopup.show(Trace::writeJson(tracePath) ? "Trace written to " + tracePath : "Could not write trace", currentTime);
+            return true;
+        };
 
-        // Prepare visible list
-        vector<Student *> visible;
-        if (!inputSearch.text.empty())
-            visible = manager.search(inputSearch.text);
-        else
-            for (auto &s : manager.students)
-                visible.push_back(&const_cast<Student &>(s));
+        // Paging keys move the list, and keep moving it while held
+        auto handleScrollKey = [&](int key)
+        {
+            if (key == GLFW_KEY_PAGE_DOWN)
+                scroll.scrollBy(listRowsH - 24);
+            else if (key == GLFW_KEY_PAGE_UP)
+                scroll.scrollBy(-(listRowsH - 24));
+            else if (key == GLFW_KEY_HOME)
+                scroll.scrollTo(0);
+            else if (key == GLFW_KEY_END)
+                scroll.scrollTo(scroll.maxOffset);
+        };
 
-        // Handle row clicks for both selection (double-click) and details view (single click)
-        if (click)
+        // Consume every event since the last frame, in the order it arrived
+        bool running = true;
+        double oldestInput = -1.0; // time of the first non-cursor event this frame
+        InputEvent ev;
+        while (running && inputQueue.pop(ev))
         {
-            float listX = 20, listTop = SCR_H - 225, listW = SCR_W - 40;
-            float ystart = listTop - 50 - scrollOffset;
-            int idx = 0;
-            for (auto *s : visible)
+            recorder.event(ev);
+            if (ev.type != InputEvent::CURSOR && oldestInput < 0)
+                oldestInput = ev.time;
+            switch (ev.type)
             {
-                float itemY = ystart - idx * 24;
-                if (itemY > 30 && itemY < listTop - 30)
+            case InputEvent::CURSOR:
+                mouseX = ev.x * metrics.cursorScale;
+                mouseY = ev.y * metrics.cursorScale;
+                break;
+            case InputEvent::MOUSE_BUTTON:
+                if (ev.code == GLFW_MOUSE_BUTTON_LEFT && ev.action == GLFW_PRESS)
                 {
-                    // Check if click is within this row
-                    if (pointInRect((float)mx, (float)my, listX + 5, itemY - 18, listW - 10, 20))
-                    {
-                        // Single click - show details panel
-                        detailsPanel.show(s, currentTime);
-                        break;
-                    }
+                    // Double clicks are timed between the events themselves, not frames
+                    bool doubleClick = ev.time - lastClickTime <= DOUBLE_CLICK_TIME;
+                    lastClickTime = ev.time;
+                    handleClick(mouseX, metrics.height - mouseY, doubleClick);
                 }
-                ++idx;
+                break;
+            case InputEvent::KEY:
+                if (ev.action == GLFW_PRESS)
+                    running = handleKey(ev.code);
+                if (ev.action != GLFW_RELEASE)
+                    handleScrollKey(ev.code);
+                break;
+            case InputEvent::CHAR:
+                handleChar((unsigned int)ev.code);
+                break;
+            case InputEvent::SCROLL:
+                // Three rows per wheel notch; positive y is away from the user
+                scroll.scrollBy(-ev.y * 3 * 24);
+                break;
             }
         }
+        if (!running)
+            break;
+        inputScope.stop();
 
-        // Handle row selection with double-click
-        if (doubleClick)
+        // Prepare visible list
+        ProfileScope queryScope(profiler, FramePhase::QUERY);
+        scroll.update(currentTime);
+        if (remote)
         {
-            float listX = 20, listTop = SCR_H - 225, listW = SCR_W - 40;
-            float ystart = listTop - 50 - scrollOffset;
-            int idx = 0;
-            for (auto *s : visible)
+            client.pollNotifications();
+            if (client.serverSeq != appliedSeq && !remoteStale && client.connected())
+                applyRemoteChanges();
+
+            // Scrolled past the fetched rows: fetch the ones around the screen
+            size_t top = (size_t)(scroll.offset / 24);
+            bool moreBelow = remoteFirst + remoteRows.size() < queryPlan.matches;
+            if (top < remoteFirst || (moreBelow && top + pageSize > remoteFirst + remoteRows.size()))
             {
-                float itemY = ystart - idx * 24;
-                if (itemY > 30 && itemY < listTop - 30)
-                {
-                    // Check if double-click is within this row
-                    if (pointInRect((float)mx, (float)my, listX + 5, itemY - 18, listW - 10, 20))
-                    {
-                        // Toggle selection
-                        auto it = find(selectedRolls.begin(), selectedRolls.end(), s->roll);
-                        if (it != selectedRolls.end())
-                        {
-                            // Already selected, deselect it
-                            selectedRolls.erase(it);
-                        }
-                        else
-                        {
-                            // Not selected, select it
-                            selectedRolls.push_back(s->roll);
-                        }
-                        break;
-                    }
-                }
-                ++idx;
+                remoteFirst = top > pageSize ? top - pageSize : 0;
+                remoteStale = true;
             }
         }
-
-        // ------------------------- Rendering -------------------------
-        glClearColor(0.06f, 0.07f, 0.08f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
-
-        // Top bar background (increased height for second row)
-        drawRect(0, SCR_H - 205, SCR_W, 205, 0.1f, 0.11f, 0.12f);
-
-        // Helper to check if button should show press effect
-        auto isButtonPressed = [&](const Button &btn)
+        refreshVisible();
+        size_t rowCount = remote ? queryPlan.matches : visible.size();
+        scroll.setRange(24.0 * rowCount, listRowsH);
+        if (leaderboardPanel.visible && leaderboardPanel.boardsVersion != manager.version)
         {
-            return btn.pressed && (currentTime - btn.pressTime < 0.2);
-        };
+            leaderboardPanel.boards = manager.leaderboards();
+            leaderboardPanel.boardsVersion = manager.version;
+        }
+        queryScope.stop();
 
-        // Buttons with press effect
-        float addOffset = isButtonPressed(btnAdd) ? 2.0f : 0.0f;
-        drawRect(btnAdd.x, btnAdd.y - addOffset, btnAdd.w, btnAdd.h,
-                 isButtonPressed(btnAdd) ? 0.15f : 0.2f,
-                 isButtonPressed(btnAdd) ? 0.5f : 0.6f,
-                 isButtonPressed(btnAdd) ? 0.15f : 0.2f);
-
-        float editOffset = isButtonPressed(btnEdit) ? 2.0f : 0.0f;
-        drawRect(btnEdit.x, btnEdit.y - editOffset, btnEdit.w, btnEdit.h,
-                 isButtonPressed(btnEdit) ? 0.15f : 0.2f,
-                 isButtonPressed(btnEdit) ? 0.4f : 0.5f,
-                 isButtonPressed(btnEdit) ? 0.7f : 0.8f);
-
-        float deleteOffset = isButtonPressed(btnDelete) ? 2.0f : 0.0f;
-        drawRect(btnDelete.x, btnDelete.y - deleteOffset, btnDelete.w, btnDelete.h,
-                 isButtonPressed(btnDelete) ? 0.7f : 0.8f,
-                 isButtonPressed(btnDelete) ? 0.25f : 0.3f,
-                 isButtonPressed(btnDelete) ? 0.25f : 0.3f);
-
-        float saveOffset = isButtonPressed(btnSave) ? 2.0f : 0.0f;
-        drawRect(btnSave.x, btnSave.y - saveOffset, btnSave.w, btnSave.h,
-                 isButtonPressed(btnSave) ? 0.6f : 0.7f,
-                 isButtonPressed(btnSave) ? 0.5f : 0.6f,
-                 isButtonPressed(btnSave) ? 0.15f : 0.2f);
-
-        float loadOffset = isButtonPressed(btnLoad) ? 2.0f : 0.0f;
-        drawRect(btnLoad.x, btnLoad.y - loadOffset, btnLoad.w, btnLoad.h,
-                 isButtonPressed(btnLoad) ? 0.4f : 0.5f,
-                 isButtonPressed(btnLoad) ? 0.4f : 0.5f,
-                 isButtonPressed(btnLoad) ? 0.4f : 0.5f);
-
-        // Button labels - centered in buttons with larger font and adjusted for offset
-        float btnScale = 1.5f;
-        float textCenterY = 25.0f;
-        drawText(btnAdd.x + 22, btnAdd.y + textCenterY - addOffset, btnAdd.label, 1, 1, 1, SCR_H, btnScale);
-        drawText(btnEdit.x + 5, btnEdit.y + textCenterY - editOffset, btnEdit.label, 1, 1, 1, SCR_H, btnScale);
-        drawText(btnDelete.x - 35, btnDelete.y + textCenterY - deleteOffset, btnDelete.label, 1, 1, 1, SCR_H, btnScale);
-        drawText(btnSave.x - 50, btnSave.y + textCenterY - saveOffset, btnSave.label, 1, 1, 1, SCR_H, btnScale);
-        drawText(btnLoad.x - 80, btnLoad.y + textCenterY - loadOffset, btnLoad.label, 1, 1, 1, SCR_H, btnScale);
-
-        // Input boxes - First row with focused color change
-        drawRect(inputName.x, inputName.y, inputName.w, inputName.h,
-                 inputName.focused ? 0.9f : 1.0f,
-                 inputName.focused ? 0.95f : 1.0f,
-                 inputName.focused ? 1.0f : 1.0f);
-        drawRect(inputRoll.x, inputRoll.y, inputRoll.w, inputRoll.h,
-                 inputRoll.focused ? 0.9f : 1.0f,
-                 inputRoll.focused ? 0.95f : 1.0f,
-                 inputRoll.focused ? 1.0f : 1.0f);
-        drawRect(inputGrade.x, inputGrade.y, inputGrade.w, inputGrade.h,
-                 inputGrade.focused ? 0.9f : 1.0f,
-                 inputGrade.focused ? 0.95f : 1.0f,
-                 inputGrade.focused ? 1.0f : 1.0f);
-        drawRect(inputSearch.x, inputSearch.y, inputSearch.w, inputSearch.h,
-                 inputSearch.focused ? 0.9f : 1.0f,
-                 inputSearch.focused ? 0.95f : 1.0f,
-                 inputSearch.focused ? 1.0f : 1.0f);
-
-        drawOutline(inputName.x, inputName.y, inputName.w, inputName.h, inputName.focused ? 0.1f : 0.25f, inputName.focused ? 0.6f : 0.25f, inputName.focused ? 0.9f : 0.25f);
-        drawOutline(inputRoll.x, inputRoll.y, inputRoll.w, inputRoll.h, inputRoll.focused ? 0.1f : 0.25f, inputRoll.focused ? 0.6f : 0.25f, inputRoll.focused ? 0.9f : 0.25f);
-        drawOutline(inputGrade.x, inputGrade.y, inputGrade.w, inputGrade.h, inputGrade.focused ? 0.1f : 0.25f, inputGrade.focused ? 0.6f : 0.25f, inputGrade.focused ? 0.9f : 0.25f);
-        drawOutline(inputSearch.x, inputSearch.y, inputSearch.w, inputSearch.h, inputSearch.focused ? 0.1f : 0.25f, inputSearch.focused ? 0.6f : 0.25f, inputSearch.focused ? 0.9f : 0.25f);
-
-        drawText(inputName.x + 8, inputName.y + 20, inputName.text.empty() ? "Name..." : inputName.text, 0, 0, 0, SCR_H, 1.5f);
-        drawText(inputRoll.x - 30, inputRoll.y + 20, inputRoll.text.empty() ? "Roll..." : inputRoll.text, 0, 0, 0, SCR_H, 1.5f);
-        drawText(inputGrade.x - 60, inputGrade.y + 20, inputGrade.text.empty() ? "Grade..." : inputGrade.text, 0, 0, 0, SCR_H, 1.5f);
-        drawText(inputSearch.x + 8, inputSearch.y + 20, inputSearch.text.empty() ? "Search name/roll..." : inputSearch.text, 0.4f, 0.4f, 0.4f, SCR_H, 1.5f);
-
-        // Input boxes - Second row with focused color change
-        drawRect(inputDepartment.x, inputDepartment.y, inputDepartment.w, inputDepartment.h,
-                 inputDepartment.focused ? 0.9f : 1.0f,
-                 inputDepartment.focused ? 0.95f : 1.0f,
-                 inputDepartment.focused ? 1.0f : 1.0f);
-        drawRect(inputCGPA.x, inputCGPA.y, inputCGPA.w, inputCGPA.h,
-                 inputCGPA.focused ? 0.9f : 1.0f,
-                 inputCGPA.focused ? 0.95f : 1.0f,
-                 inputCGPA.focused ? 1.0f : 1.0f);
-
-        drawOutline(inputDepartment.x, inputDepartment.y, inputDepartment.w, inputDepartment.h, inputDepartment.focused ? 0.1f : 0.25f, inputDepartment.focused ? 0.6f : 0.25f, inputDepartment.focused ? 0.9f : 0.25f);
-        drawOutline(inputCGPA.x, inputCGPA.y, inputCGPA.w, inputCGPA.h, inputCGPA.focused ? 0.1f : 0.25f, inputCGPA.focused ? 0.6f : 0.25f, inputCGPA.focused ? 0.9f : 0.25f);
-
-        drawText(inputDepartment.x + 8, inputDepartment.y + 20, inputDepartment.text.empty() ? "Department..." : inputDepartment.text, 0, 0, 0, SCR_H, 1.5f);
-        drawText(inputCGPA.x - 30, inputCGPA.y + 20, inputCGPA.text.empty() ? "CGPA..." : inputCGPA.text, 0, 0, 0, SCR_H, 1.5f);
-
-        // List background
-        float listX = 20, listTop = SCR_H - 225, listW = SCR_W - 40, listH = SCR_H - 245;
-        drawRect(listX, 20, listW, listH, 0.12f, 0.13f, 0.14f);
-        drawOutline(listX, 20, listW, listH, 0.2f, 0.2f, 0.2f);
-
-        // List header - with Department and CGPA columns (clickable for sorting)
-        float headerX = listX + 10;
-        float headerY = listTop - 20;
-
-        // Draw column headers with sort indicators
-        string rollHeader = "Roll";
-        string nameHeader = "Name";
-        string deptHeader = "Department";
-        string gradeHeader = "Grade";
-        string cgpaHeader = "CGPA";
-
-        // Add sort indicators (^ for ascending, v for descending)
-        if (manager.sortState.column == SortColumn::ROLL)
+        // ------------------------- Rendering -------------------------
+        ProfileScope drawScope(profiler, FramePhase::DRAW);
+
+        // List items - with Department and CGPA columns. The layer holds a
+        // page of rows either side of the ones on screen; it is rebuilt when
+        // the rows or selection change or the view scrolls out of it, and is
+        // otherwise only moved.
+        // The scroll position picks the rows straight away; connected, only
+        // rows [rowsBegin, rowsEnd) of the matches are held in `visible`.
+        size_t rowsBegin = remote ? remoteFirst : 0, rowsEnd = rowsBegin + visible.size();
+        size_t firstOnScreen = min(rowsEnd, max(rowsBegin, (size_t)max(0.0, scroll.offset / 24 - 1)));
+        size_t endOnScreen = min(rowsEnd, firstOnScreen + pageRows + 2);
+        if (listLayerVersion != listVersion || firstOnScreen < listLayerFirst || endOnScreen > listLayerEnd)
         {
-            rollHeader += (manager.sortState.ascending ? " ^" : " v");
+            listLayerFirst = max(rowsBegin, firstOnScreen > pageRows ? firstOnScreen - pageRows : 0);
+            listLayerEnd = min(rowsEnd, endOnScreen + pageRows);
+            buildListLayer(visible, selectedRolls, listLayerFirst - rowsBegin, listLayerEnd - rowsBegin, listX, listTop, listW, SCR_H);
+            listLayerVersion = listVersion;
         }
-        else if (manager.sortState.column == SortColumn::NAME)
+        // Rows sit between the list's bottom edge and the header, inside the
+        // outline. The cache redraws only what the rows or the scroll changed;
+        // scrolling snaps to whole framebuffer pixels so shifted pixels stay exact.
+        int scrollPx = (int)floor(scroll.offset * metrics.scale);
+        bool listChanged = listCacheVersion != listVersion;
+        bool rowsRedrawn = renderer.updateCache(listCache, listLayer, (float)(scrollPx / metrics.scale - 24.0 * listLayerFirst),
+                                                scrollPx, listChanged, listX, 20, 0.12f, 0.13f, 0.14f);
+        listCacheVersion = listVersion;
+
+        // Damage: the bounds of every element that changed since the backing
+        // store was last drawn
+        if (!backing.valid)
+            damage.add(0, 0, (float)SCR_W, (float)SCR_H);
+        for (Button *btn : buttons)
         {
-            nameHeader += (manager.sortState.ascending ? " ^" : " v");
+            btn->update(currentTime);
+            if (btn->dirty)
+                damage.add(btn->x - 1, btn->y - 3, btn->w + 2, btn->h + 4); // drops 2px while pressed
+            btn->dirty = false;
         }
-        else if (manager.sortState.column == SortColumn::DEPARTMENT)
+        for (InputBox *box : inputBoxes)
         {
-            deptHeader += (manager.sortState.ascending ? " ^" : " v");
+            box->update();
+            // Text is not clipped to its box, so the rest of the row goes too
+            if (box->dirty)
+                damage.add(box->x - 1, box->y - 1, SCR_W - box->x + 1, box->h + 1);
+            box->dirty = false;
         }
-        else if (manager.sortState.column == SortColumn::GRADE)
+        if (rowsRedrawn)
+            damage.add(listX, 20, listW - 1, listTop - 68);
+        int sortKey = (int)manager.sortState.column * 2 + (manager.sortState.ascending ? 1 : 0);
+        if (listChanged || sortKey != drawnSortKey)
         {
-            gradeHeader += (manager.sortState.ascending ? " ^" : " v");
+            // New rows come with a new query plan line and sort arrows, and
+            // may change what the panels show
+            damage.add(listX - 1, listTop - 48, listW + 1, 48);
+            damage.add(inputCGPA.x + inputCGPA.w, inputCGPA.y, SCR_W - inputCGPA.x - inputCGPA.w, inputCGPA.h);
+            detailsPanel.dirty |= detailsPanel.visible;
+            statsPanel.dirty |= statsPanel.visible;
+            leaderboardPanel.dirty |= leaderboardPanel.visible;
+            drawnSortKey = sortKey;
         }
-        else if (manager.sortState.column == SortColumn::CGPA)
+        messagePopup.update(currentTime);
+        detailsPanel.update(currentTime);
+        statsPanel.update(currentTime);
+        leaderboardPanel.update(currentTime);
+        // The popup and the details panel dim the whole window; the side
+        // panels stay in the slot left of where the details panel docks
+        if (messagePopup.dirty || detailsPanel.dirty)
+            damage.add(0, 0, (float)SCR_W, (float)SCR_H);
+        if (statsPanel.dirty || leaderboardPanel.dirty)
+            damage.add(SCR_W - 740.0f, 0, 740.0f, (float)SCR_H);
+        messagePopup.dirty = detailsPanel.dirty = statsPanel.dirty = leaderboardPanel.dirty = false;
+        // The profiler's numbers change every frame, and its longer lines run
+        // past the right of its box
+        if (showProfiler || profilerDrawn)
+            damage.add(PROFILER_X, PROFILER_Y, PROFILER_W + 200, PROFILER_H);
+        profilerDrawn = showProfiler;
+
+        // Everything, back to front; the clip limits it to one damaged
+        // rectangle, and parts entirely outside that are skipped
+        auto drawScene = [&]()
         {
-            cgpaHeader += (manager.sortState.ascending ? " ^" : " v");
-        }
+            glClearColor(0.06f, 0.07f, 0.08f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
 
-        drawText(headerX, headerY, rollHeader, 0.8f, 0.8f, 0.8f, SCR_H, 1.4f);
-        drawText(headerX + 80, headerY, nameHeader, 0.8f, 0.8f, 0.8f, SCR_H, 1.4f);
-        drawText(headerX + 320, headerY, deptHeader, 0.8f, 0.8f, 0.8f, SCR_H, 1.4f);
-        drawText(headerX + 520, headerY, gradeHeader, 0.8f, 0.8f, 0.8f, SCR_H, 1.4f);
-        drawText(headerX + 620, headerY, cgpaHeader, 0.8f, 0.8f, 0.8f, SCR_H, 1.4f);
+            if (renderer.clipTouches(0, SCR_H - 205, SCR_W, 205))
+            {
+                // Top bar background (increased height for second row)
+                drawRect(0, SCR_H - 205, SCR_W, 205, 0.1f, 0.11f, 0.12f);
 
-        // List items - with Department and CGPA columns
-        float ystart = listTop - 50 - scrollOffset;
-        int idx = 0;
-        for (auto *s : visible)
-        {
-            float itemY = ystart - idx * 24;
-            if (itemY > 30 && itemY < listTop - 30)
-            { // Only draw visible items
-                // Check if this student is selected
-                bool isSelected = find(selectedRolls.begin(), selectedRolls.end(), s->roll) != selectedRolls.end();
-
-                // Draw background with selection highlight
-                if (isSelected)
-                    drawRect(listX + 5, itemY - 18, listW - 10, 20, 0.2f, 0.4f, 0.6f); // Blue highlight for selected
-                else
-                    drawRect(listX + 5, itemY - 18, listW - 10, 20, 0.15f, 0.16f, 0.17f);
-
-                // Draw each column at fixed positions
-                float dataX = listX + 12;
-                drawText(dataX, itemY - 2, to_string(s->roll), 0.9f, 0.9f, 0.9f, SCR_H, 1.3f);
-                drawText(dataX + 80, itemY - 2, s->name, 0.9f, 0.9f, 0.9f, SCR_H, 1.3f);
-                drawText(dataX + 320, itemY - 2, s->department, 0.9f, 0.9f, 0.9f, SCR_H, 1.3f);
-                drawText(dataX + 520, itemY - 2, s->grade, 0.9f, 0.9f, 0.9f, SCR_H, 1.3f);
-
-                // Format CGPA to 2 decimal places
-                char cgpaStr[10];
-                snprintf(cgpaStr, sizeof(cgpaStr), "%.2f", s->cgpa);
-                drawText(dataX + 620, itemY - 2, string(cgpaStr), 0.9f, 0.9f, 0.9f, SCR_H, 1.3f);
+                // Helper to check if button should show press effect
+                auto isButtonPressed = [&](const Button &btn)
+                {
+                    return btn.showsPress(currentTime);
+                };
+
+                // Buttons with press effect
+                float addOffset = isButtonPressed(btnAdd) ? 2.0f : 0.0f;
+                drawRect(btnAdd.x, btnAdd.y - addOffset, btnAdd.w, btnAdd.h,
+                         isButtonPressed(btnAdd) ? 0.15f : 0.2f,
+                         isButtonPressed(btnAdd) ? 0.5f : 0.6f,
+                         isButtonPressed(btnAdd) ? 0.15f : 0.2f);
+
+                float editOffset = isButtonPressed(btnEdit) ? 2.0f : 0.0f;
+                drawRect(btnEdit.x, btnEdit.y - editOffset, btnEdit.w, btnEdit.h,
+                         isButtonPressed(btnEdit) ? 0.15f : 0.2f,
+                         isButtonPressed(btnEdit) ? 0.4f : 0.5f,
+                         isButtonPressed(btnEdit) ? 0.7f : 0.8f);
+
+                float deleteOffset = isButtonPressed(btnDelete) ? 2.0f : 0.0f;
+                drawRect(btnDelete.x, btnDelete.y - deleteOffset, btnDelete.w, btnDelete.h,
+                         isButtonPressed(btnDelete) ? 0.7f : 0.8f,
+                         isButtonPressed(btnDelete) ? 0.25f : 0.3f,
+                         isButtonPressed(btnDelete) ? 0.25f : 0.3f);
+
+                float saveOffset = isButtonPressed(btnSave) ? 2.0f : 0.0f;
+                drawRect(btnSave.x, btnSave.y - saveOffset, btnSave.w, btnSave.h,
+                         isButtonPressed(btnSave) ? 0.6f : 0.7f,
+                         isButtonPressed(btnSave) ? 0.5f : 0.6f,
+                         isButtonPressed(btnSave) ? 0.15f : 0.2f);
+
+                float loadOffset = isButtonPressed(btnLoad) ? 2.0f : 0.0f;
+                drawRect(btnLoad.x, btnLoad.y - loadOffset, btnLoad.w, btnLoad.h,
+                         isButtonPressed(btnLoad) ? 0.4f : 0.5f,
+                         isButtonPressed(btnLoad) ? 0.4f : 0.5f,
+                         isButtonPressed(btnLoad) ? 0.4f : 0.5f);
+
+                float statsOffset = isButtonPressed(btnStats) ? 2.0f : 0.0f;
+                drawRect(btnStats.x, btnStats.y - statsOffset, btnStats.w, btnStats.h,
+                         isButtonPressed(btnStats) ? 0.2f : 0.25f,
+                         isButtonPressed(btnStats) ? 0.45f : 0.55f,
+                         isButtonPressed(btnStats) ? 0.35f : 0.45f);
+
+                float topOffset = isButtonPressed(btnTop) ? 2.0f : 0.0f;
+                drawRect(btnTop.x, btnTop.y - topOffset, btnTop.w, btnTop.h,
+                         isButtonPressed(btnTop) ? 0.55f : 0.65f,
+                         isButtonPressed(btnTop) ? 0.4f : 0.5f,
+                         isButtonPressed(btnTop) ? 0.15f : 0.2f);
+
+                // Button labels - centered in buttons with larger font and adjusted for offset
+                float btnScale = 1.5f;
+                float textCenterY = 25.0f;
+                drawText(btnAdd.x + 22, btnAdd.y + textCenterY - addOffset, btnAdd.label, 1, 1, 1, SCR_H, btnScale);
+                drawText(btnEdit.x + 5, btnEdit.y + textCenterY - editOffset, btnEdit.label, 1, 1, 1, SCR_H, btnScale);
+                drawText(btnDelete.x - 35, btnDelete.y + textCenterY - deleteOffset, btnDelete.label, 1, 1, 1, SCR_H, btnScale);
+                drawText(btnSave.x - 50, btnSave.y + textCenterY - saveOffset, btnSave.label, 1, 1, 1, SCR_H, btnScale);
+                drawText(btnLoad.x - 80, btnLoad.y + textCenterY - loadOffset, btnLoad.label, 1, 1, 1, SCR_H, btnScale);
+                drawText(btnStats.x - 100, btnStats.y + textCenterY - statsOffset, btnStats.label, 1, 1, 1, SCR_H, btnScale);
+                drawText(btnTop.x - 128, btnTop.y + textCenterY - topOffset, btnTop.label, 1, 1, 1, SCR_H, btnScale);
+
+                // Input boxes - First row with focused color change
+                drawRect(inputName.x, inputName.y, inputName.w, inputName.h,
+                         inputName.focused ? 0.9f : 1.0f,
+                         inputName.focused ? 0.95f : 1.0f,
+                         inputName.focused ? 1.0f : 1.0f);
+                drawRect(inputRoll.x, inputRoll.y, inputRoll.w, inputRoll.h,
+                         inputRoll.focused ? 0.9f : 1.0f,
+                         inputRoll.focused ? 0.95f : 1.0f,
+                         inputRoll.focused ? 1.0f : 1.0f);
+                drawRect(inputGrade.x, inputGrade.y, inputGrade.w, inputGrade.h,
+                         inputGrade.focused ? 0.9f : 1.0f,
+                         inputGrade.focused ? 0.95f : 1.0f,
+                         inputGrade.focused ? 1.0f : 1.0f);
+                drawRect(inputSearch.x, inputSearch.y, inputSearch.w, inputSearch.h,
+                         inputSearch.focused ? 0.9f : 1.0f,
+                         inputSearch.focused ? 0.95f : 1.0f,
+                         inputSearch.focused ? 1.0f : 1.0f);
+
+                drawOutline(inputName.x, inputName.y, inputName.w, inputName.h, inputName.focused ? 0.1f : 0.25f, inputName.focused ? 0.6f : 0.25f, inputName.focused ? 0.9f : 0.25f);
+                drawOutline(inputRoll.x, inputRoll.y, inputRoll.w, inputRoll.h, inputRoll.focused ? 0.1f : 0.25f, inputRoll.focused ? 0.6f : 0.25f, inputRoll.focused ? 0.9f : 0.25f);
+                drawOutline(inputGrade.x, inputGrade.y, inputGrade.w, inputGrade.h, inputGrade.focused ? 0.1f : 0.25f, inputGrade.focused ? 0.6f : 0.25f, inputGrade.focused ? 0.9f : 0.25f);
+                drawOutline(inputSearch.x, inputSearch.y, inputSearch.w, inputSearch.h, inputSearch.focused ? 0.1f : 0.25f, inputSearch.focused ? 0.6f : 0.25f, inputSearch.focused ? 0.9f : 0.25f);
+
+                drawText(inputName.x + 8, inputName.y + 20, inputName.text.empty() ? "Name..." : inputName.text.c_str(), 0, 0, 0, SCR_H, 1.5f);
+                drawText(inputRoll.x - 30, inputRoll.y + 20, inputRoll.text.empty() ? "Roll..." : inputRoll.text.c_str(), 0, 0, 0, SCR_H, 1.5f);
+                drawText(inputGrade.x - 60, inputGrade.y + 20, inputGrade.text.empty() ? "Grade..." : inputGrade.text.c_str(), 0, 0, 0, SCR_H, 1.5f);
+                drawText(inputSearch.x + 8, inputSearch.y + 20, inputSearch.text.empty() ? "Search (dept:CSE cgpa>=3.5 name~...)" : inputSearch.text.c_str(), 0.4f, 0.4f, 0.4f, SCR_H, 1.5f);
+
+                // Input boxes - Second row with focused color change
+                drawRect(inputDepartment.x, inputDepartment.y, inputDepartment.w, inputDepartment.h,
+                         inputDepartment.focused ? 0.9f : 1.0f,
+                         inputDepartment.focused ? 0.95f : 1.0f,
+                         inputDepartment.focused ? 1.0f : 1.0f);
+                drawRect(inputCGPA.x, inputCGPA.y, inputCGPA.w, inputCGPA.h,
+                         inputCGPA.focused ? 0.9f : 1.0f,
+                         inputCGPA.focused ? 0.95f : 1.0f,
+                         inputCGPA.focused ? 1.0f : 1.0f);
+
+                drawOutline(inputDepartment.x, inputDepartment.y, inputDepartment.w, inputDepartment.h, inputDepartment.focused ? 0.1f : 0.25f, inputDepartment.focused ? 0.6f : 0.25f, inputDepartment.focused ? 0.9f : 0.25f);
+                drawOutline(inputCGPA.x, inputCGPA.y, inputCGPA.w, inputCGPA.h, inputCGPA.focused ? 0.1f : 0.25f, inputCGPA.focused ? 0.6f : 0.25f, inputCGPA.focused ? 0.9f : 0.25f);
+
+                drawText(inputDepartment.x + 8, inputDepartment.y + 20, inputDepartment.text.empty() ? "Department..." : inputDepartment.text.c_str(), 0, 0, 0, SCR_H, 1.5f);
+                drawText(inputCGPA.x - 30, inputCGPA.y + 20, inputCGPA.text.empty() ? "CGPA..." : inputCGPA.text.c_str(), 0, 0, 0, SCR_H, 1.5f);
+
+                // Query plan and stage timings for the current search
+                if (!inputSearch.text.empty())
+                {
+                    char planStr[256];
+                    if (!queryPlan.error.empty())
+                        snprintf(planStr, sizeof(planStr), "Query error: %s", queryPlan.error.c_str());
+                    else
+                        snprintf(planStr, sizeof(planStr), "%s  %zu rows  parse %.2f plan %.2f index %.2f scan %.2f ms",
+                                 queryPlan.plan.c_str(), queryPlan.matches, queryPlan.parseMs, queryPlan.planMs, queryPlan.indexMs, queryPlan.scanMs);
+                    drawText(280, inputCGPA.y + 20, planStr, 0.6f, 0.7f, 0.6f, SCR_H, 1.0f);
+                }
             }
-            ++idx;
-        }
 
-        // Draw message popup (on top of everything except details panel)
-        drawMessagePopup(messagePopup, SCR_W, SCR_H, currentTime);
+            if (renderer.clipTouches(listX - 1, 19, listW + 1, listH + 1))
+            {
+                // List background
+                drawRect(listX, 20, listW, listH, 0.12f, 0.13f, 0.14f);
+                drawOutline(listX, 20, listW, listH, 0.2f, 0.2f, 0.2f);
 
-        // Draw details panel (on top of everything)
-        drawDetailsPanel(detailsPanel, SCR_W, SCR_H, currentTime);
+                // List header - with Department and CGPA columns (clickable for sorting)
+                float headerX = listX + 10;
+                float headerY = listTop - 20;
+
+                // Draw column headers with sort indicators (^ for ascending, v for descending)
+                const char *arrow = manager.sortState.ascending ? " ^" : " v";
+                auto indicator = [&](SortColumn column)
+                {
+                    return manager.sortState.column == column ? arrow : "";
+                };
+                const char *rollHeader = frameArena.format("Roll%s", indicator(SortColumn::ROLL));
+                const char *nameHeader = frameArena.format("Name%s", indicator(SortColumn::NAME));
+                const char *deptHeader = frameArena.format("Department%s", indicator(SortColumn::DEPARTMENT));
+                const char *gradeHeader = frameArena.format("Grade%s", indicator(SortColumn::GRADE));
+                const char *cgpaHeader = frameArena.format("CGPA%s", indicator(SortColumn::CGPA));
+
+                drawText(headerX, headerY, rollHeader, 0.8f, 0.8f, 0.8f, SCR_H, 1.4f);
+                drawText(headerX + 80, headerY, nameHeader, 0.8f, 0.8f, 0.8f, SCR_H, 1.4f);
+                drawText(headerX + 320, headerY, deptHeader, 0.8f, 0.8f, 0.8f, SCR_H, 1.4f);
+                drawText(headerX + 520, headerY, gradeHeader, 0.8f, 0.8f, 0.8f, SCR_H, 1.4f);
+                drawText(headerX + 620, headerY, cgpaHeader, 0.8f, 0.8f, 0.8f, SCR_H, 1.4f);
+
+                renderer.drawCache(listCache, listX, 20);
+            }
+
+            // Draw message popup (on top of everything except details panel)
+            drawMessagePopup(messagePopup, SCR_W, SCR_H, currentTime);
+
+            // Draw side panels, then details panel (on top of everything)
+            drawStatsPanel(statsPanel, manager, detailsPanel.visible, SCR_W, SCR_H, currentTime);
+            drawLeaderboardPanel(leaderboardPanel, detailsPanel.visible, SCR_W, SCR_H, currentTime);
+            drawDetailsPanel(detailsPanel, manager, !remote, SCR_W, SCR_H, currentTime);
+
+            // Profiler overlay (F3) is drawn last so it is never covered
+            if (showProfiler && renderer.clipTouches(PROFILER_X, PROFILER_Y, PROFILER_W + 200, PROFILER_H))
+                drawProfilerOverlay(profiler, SCR_H);
+        };
+
+        // Redraw the damage into the backing store, then copy all of it to
+        // the window: the swap does not keep the last frame's pixels
+        renderer.beginBacking(backing);
+        for (int i = 0; i < damage.count; ++i)
+        {
+            const DamageRegion::Rect &r = damage.rects[i];
+            renderer.setClip(r.x0, r.y0, r.x1 - r.x0, r.y1 - r.y0);
+            drawScene();
+        }
+        damage.clear();
+        renderer.presentBacking(backing);
+        renderer.endFrame();
+        drawScope.stop();
 
+        ProfileScope swapScope(profiler, FramePhase::SWAP);
         glfwSwapBuffers(window);
+        swapScope.stop();
+        if (oldestInput >= 0 && !replaying)
+            profiler.addInputLatency((float)((glfwGetTime() - oldestInput) * 1000.0));
+        profiler.endFrame();
+        if (replaying)
+            replayReport.add(profiler.frame(0));
+
+        if (allocCheck.active)
+        {
+            int stage = allocCheck.stage();
+            if (allocCheck.frameInStage() == 0)
+            {
+                // Set up the state for this stage, then let it settle
+                statsPanel.visible = stage == 1;
+                leaderboardPanel.visible = stage == 2;
+                if (stage == 2 && !visible.empty())
+                    detailsPanel.show(visible[0], currentTime);
+            }
+            if (allocCheck.frameInStage() == AllocCheck::WARMUP_FRAMES - 1)
+                allocCheck.stageStart = AllocStats::count();
+            ++allocCheck.frame;
+            if (allocCheck.frameInStage() == 0)
+                allocCheck.allocations[stage] = AllocStats::count() - allocCheck.stageStart;
+            if (allocCheck.done())
+                break;
+        }
+    }
+
+    if (allocCheck.active)
+    {
+        static const char *stageNames[AllocCheck::STAGES] = {"list", "stats", "leaderboard+details"};
+        for (int i = 0; i < AllocCheck::STAGES; ++i)
+            printf("%-20s %llu allocations over %d frames\n", stageNames[i],
+                   (unsigned long long)allocCheck.allocations[i], AllocCheck::MEASURED_FRAMES);
+        printf(allocCheck.total() == 0 ? "PASS: steady-state frames do not allocate\n"
+                                       : "FAIL: steady-state frames allocate\n");
+    }
+
+    if (replaying)
+    {
+        replayReport.wallSeconds = chrono::duration<double>(chrono::steady_clock::now() - replayStart).count();
+        printf("replay %s: %zu of %zu frames\n", replayPath.c_str(), replay.next, replay.frames.size());
+        replayReport.print();
+        if (!replayJsonPath.empty() && !replayReport.writeJson(replayJsonPath, replayPath))
+            cerr << "Could not write " << replayJsonPath << "\n";
+        remove(dataPath.c_str());
     }
 
+    // Anything captured but not yet flushed goes to disk on exit
+    if (Trace::eventCount() > 0)
+        Trace::writeJson(tracePath);
+
+    renderer.destroyBacking(backing);
+    renderer.destroyCache(listCache);
+    renderer.destroyInstances(listLayer);
+    renderer.shutdown();
     glfwTerminate();
+    if (allocCheck.active)
+        return allocCheck.done() && allocCheck.total() == 0 ? 0 : 1;
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,676 @@
+// roster_cli.cpp
+// Headless batch tool for roster files (no GLFW/OpenGL). Every command reads
+// roster data from a file or stdin and writes to stdout or -o, so commands
+// can be piped together:
+//
+//   roster_cli import  [--format csv|tsv] [--dedupe]    CSV/TSV -> roster lines
+//   roster_cli export  [--format csv|tsv|json]          roster lines -> CSV/TSV/JSON
+//   roster_cli query   <expression>                     rows matching a search-box query
+//   roster_cli stats   [--json] [--shm[=/students]]     aggregates per department and grade
+//   roster_cli compact [--sort column] [--desc]         drop bad rows and duplicate rolls
+//
+//   common: [-o output] [input | -]
+//
+// import, export, query and stats stream their input in fixed-size pieces.
+// compact keeps one bit per roll, and --sort spills sorted runs of
+// RUN_ROWS rows to temporary files and merges them, so memory stays bounded
+// however large the roster is. stats --shm reads a snapshot published by
+// roster_server --publish in place instead of parsing a file.
+#include "student_manager.h"
+#include <iostream>
+#include <fstream>
+#include <queue>
+#include <cstdio>
+#include <unordered_map>
+#ifndef _WIN32
+#include "roster_snapshot.h"
+#endif
+using namespace std;
+
+// ------------------------- Options -------------------------
+class CliOptions
+{
+public:
+    string command;
+    string input = "-";
+    string output = "-";
+    string format;
+    string expression;
+    string sortColumn;
+    string tmpPrefix = "roster_sort";
+    string shm; // snapshot name for stats --shm
+    bool dedupe = false;
+    bool descending = false;
+    bool json = false;
+};
+
+static void usage()
+{
+    cerr << "Usage: roster_cli <command> [options] [input | -]\n"
+         << "  import  [--format csv|tsv] [--dedupe]   CSV/TSV rows to roster lines\n"
+         << "  export  [--format csv|tsv|json]         roster lines to CSV/TSV/JSON\n"
+         << "  query   <expression>                    rows matching a query (dept:CSE cgpa>=3.5 ...)\n"
+         << "  stats   [--json] [--shm[=/students]]    aggregates per department and grade\n"
+         << "  compact [--sort roll|name|department|grade|cgpa] [--desc] [--tmp prefix]\n"
+         << "                                          drop malformed rows and duplicate rolls\n"
+         << "  -o file writes to file instead of stdout; input defaults to stdin\n";
+}
+
+// ------------------------- Streaming helpers -------------------------
+// Reads roster lines, counting the ones that don't parse
+class RosterReader
+{
+public:
+    size_t rows = 0;
+    size_t skipped = 0;
+
+    explicit RosterReader(istream &in) : in(in) {}
+
+    bool next(Student &s)
+    {
+        while (getline(in, line))
+        {
+            if (line.empty() || line == "\r")
+                continue;
+            if (parseStudentLine(line, s))
+            {
+                ++rows;
+                return true;
+            }
+            ++skipped;
+        }
+        return false;
+    }
+
+private:
+    istream &in;
+    string line;
+};
+
+// First occurrence of each roll wins; one bit per roll seen
+class RollFilter
+{
+public:
+    size_t duplicates = 0;
+
+    bool firstTime(int roll)
+    {
+        if (seen.contains((uint32_t)roll))
+        {
+            ++duplicates;
+            return false;
+        }
+        seen.add((uint32_t)roll);
+        return true;
+    }
+
+private:
+    RoaringBitmap seen;
+};
+
+static float clampCgpa(float cgpa) { return cgpa < 0.0f ? 0.0f : (cgpa > 4.0f ? 4.0f : cgpa); }
+
+static string trim(const string &s)
+{
+    size_t b = s.find_first_not_of(" \t\r");
+    if (b == string::npos)
+        return "";
+    size_t e = s.find_last_not_of(" \t\r");
+    return s.substr(b, e - b + 1);
+}
+
+// Split one CSV record, honouring "quoted, fields" and "" escapes
+static void splitCsv(const string &line, vector<string> &fields)
+{
+    fields.clear();
+    string field;
+    bool quoted = false;
+    for (size_t i = 0; i < line.size(); ++i)
+    {
+        char c = line[i];
+        if (quoted)
+        {
+            if (c == '"' && i + 1 < line.size() && line[i + 1] == '"')
+                field += '"', ++i;
+            else if (c == '"')
+                quoted = false;
+            else
+                field += c;
+        }
+        else if (c == '"')
+            quoted = true;
+        else if (c == ',')
+            fields.push_back(field), field.clear();
+        else
+            field += c;
+    }
+    fields.push_back(field);
+}
+
+static void writeCsvField(ostream &out, const string &s)
+{
+    if (s.find_first_of(",\"\n") == string::npos)
+    {
+        out << s;
+        return;
+    }
+    out << '"';
+    for (char c : s)
+        out << (c == '"' ? "\"\"" : string(1, c));
+    out << '"';
+}
+
+static void writeJsonString(ostream &out, const string &s)
+{
+    out << '"';
+    for (char c : s)
+    {
+        if (c == '"' || c == '\\')
+            out << '\\' << c;
+        else if ((unsigned char)c < 0x20)
+        {
+            char esc[8];
+            snprintf(esc, sizeof(esc), "\\u%04x", c);
+            out << esc;
+        }
+        else
+            out << c;
+    }
+    out << '"';
+}
+
+// ------------------------- Commands -------------------------
+static int runImport(const CliOptions &opt, istream &in, ostream &out)
+{
+    bool csv = opt.format.empty() || opt.format == "csv";
+    if (!csv && opt.format != "tsv")
+    {
+        cerr << "import: unknown format " << opt.format << "\n";
+        return 2;
+    }
+    RollFilter rolls;
+    vector<string> fields;
+    string line;
+    size_t rows = 0, skipped = 0;
+    while (getline(in, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.empty())
+            continue;
+        if (csv)
+            splitCsv(line, fields);
+        else
+        {
+            fields.clear();
+            stringstream ss(line);
+            string f;
+            while (getline(ss, f, '\t'))
+                fields.push_back(f);
+        }
+        // name, roll, grade, department, cgpa; headers and short rows are skipped
+        Student s;
+        try
+        {
+            if (fields.size() < 5)
+                throw invalid_argument("fields");
+            s.name = trim(fields[0]);
+            s.roll = stoi(fields[1]);
+            s.grade = trim(fields[2]);
+            s.department = trim(fields[3]);
+            s.cgpa = stof(fields[4]);
+            if (!isfinite(s.cgpa))
+                throw invalid_argument("cgpa"); // nan/inf would be invalid JSON on export
+            s.cgpa = clampCgpa(s.cgpa);
+        }
+        catch (...)
+        {
+            ++skipped;
+            continue;
+        }
+        if (opt.dedupe && !rolls.firstTime(s.roll))
+            continue;
+        cleanStudentFields(s);
+        writeStudentLine(out, s);
+        ++rows;
+    }
+    cerr << "import: " << rows << " rows, " << skipped << " skipped, " << rolls.duplicates << " duplicates\n";
+    return 0;
+}
+
+static int runExport(const CliOptions &opt, istream &in, ostream &out)
+{
+    string format = opt.format.empty() ? "csv" : opt.format;
+    if (format != "csv" && format != "tsv" && format != "json")
+    {
+        cerr << "export: unknown format " << format << "\n";
+        return 2;
+    }
+    RosterReader reader(in);
+    Student s;
+    if (format == "csv")
+        out << "name,roll,grade,department,cgpa\n";
+    if (format == "json")
+        out << "[";
+    while (reader.next(s))
+    {
+        if (format == "tsv")
+            writeStudentLine(out, s);
+        else if (format == "csv")
+        {
+            writeCsvField(out, s.name);
+            out << ',' << s.roll << ',';
+            writeCsvField(out, s.grade);
+            out << ',';
+            writeCsvField(out, s.department);
+            out << ',' << s.cgpa << '\n';
+        }
+        else
+        {
+            out << (reader.rows > 1 ? ",\n " : "\n ") << "{\"name\": ";
+            writeJsonString(out, s.name);
+            out << ", \"roll\": " << s.roll << ", \"grade\": ";
+            writeJsonString(out, s.grade);
+            out << ", \"department\": ";
+            writeJsonString(out, s.department);
+            out << ", \"cgpa\": " << s.cgpa << "}";
+        }
+    }
+    if (format == "json")
+        out << "\n]\n";
+    cerr << "export: " << reader.rows << " rows, " << reader.skipped << " skipped\n";
+    return 0;
+}
+
+// Runs the GUI's query engine over pieces of QUERY_CHUNK rows at a time
+static int runQuery(const CliOptions &opt, istream &in, ostream &out)
+{
+    static constexpr size_t QUERY_CHUNK = 1 << 16;
+
+    StudentManager manager;
+    QueryPlan plan;
+    manager.query(opt.expression, &plan);
+    if (!plan.error.empty())
+    {
+        cerr << "query: " << plan.error << "\n";
+        return 2;
+    }
+
+    RosterReader reader(in);
+    size_t matches = 0;
+    bool more = true;
+    while (more)
+    {
+        vector<Student> chunk;
+        chunk.reserve(QUERY_CHUNK);
+        Student s;
+        while (chunk.size() < QUERY_CHUNK && (more = reader.next(s)))
+            chunk.push_back(s);
+        if (chunk.empty())
+            break;
+        manager.assign(move(chunk));
+        vector<Student *> hits = manager.query(opt.expression);
+        for (Student *m : hits)
+            writeStudentLine(out, *m);
+        matches += hits.size();
+    }
+    cerr << "query: " << matches << " of " << reader.rows << " rows matched\n";
+    return 0;
+}
+
+static void writeGroupText(ostream &out, const string &label, const GroupStats &g)
+{
+    char line[128];
+    snprintf(line, sizeof(line), "%-12s %10llu  %.2f  %.2f-%.2f\n", label.empty() ? "-" : label.c_str(),
+             (unsigned long long)g.count, g.mean(), g.minCgpa(), g.maxCgpa());
+    out << line;
+}
+
+static void writeGroupJson(ostream &out, const string &label, const GroupStats &g)
+{
+    out << "{\"group\": ";
+    writeJsonString(out, label);
+    out << ", \"count\": " << g.count << ", \"mean\": " << g.mean() << ", \"min\": " << g.minCgpa()
+        << ", \"max\": " << g.maxCgpa() << "}";
+}
+
+#ifndef _WIN32
+// Aggregate a shared-memory snapshot in place; each distinct department and
+// grade string is copied once, not once per row
+static int statsFromSnapshot(const string &name, RosterAggregates &agg, CgpaFenwick &ranks)
+{
+    RosterSnapshot snap;
+    if (!snap.open(name))
+    {
+        cerr << "stats: " << snap.error << "\n";
+        return 1;
+    }
+    unordered_map<string_view, GroupStats *> departments, grades;
+    auto group = [](unordered_map<string_view, GroupStats *> &cache, map<string, GroupStats> &groups, string_view key)
+    {
+        GroupStats *&g = cache[key];
+        if (!g)
+            g = &groups[string(key)];
+        return g;
+    };
+    for (size_t i = 0; i < snap.rows(); ++i)
+    {
+        float cgpa = snap.cgpa(i);
+        agg.overall.insert(cgpa);
+        group(departments, agg.byDepartment, snap.department(i))->insert(cgpa);
+        group(grades, agg.byGrade, snap.grade(i))->insert(cgpa);
+        ranks.add(cgpa, 1);
+    }
+    cerr << "stats: " << snap.rows() << " rows from snapshot " << name << " (epoch " << snap.epoch() << ")\n";
+    return 0;
+}
+#endif
+
+static int runStats(const CliOptions &opt, istream &in, ostream &out)
+{
+    RosterAggregates agg;
+    CgpaFenwick ranks;
+    size_t rows = 0, skipped = 0;
+    if (!opt.shm.empty())
+    {
+#ifdef _WIN32
+        cerr << "stats: --shm needs POSIX shared memory\n";
+        return 2;
+#else
+        if (int rc = statsFromSnapshot(opt.shm, agg, ranks))
+            return rc;
+#endif
+    }
+    else
+    {
+        RosterReader reader(in);
+        Student s;
+        while (reader.next(s))
+        {
+            agg.insert(s);
+            ranks.add(s.cgpa, 1);
+        }
+        rows = reader.rows;
+        skipped = reader.skipped;
+    }
+
+    if (opt.json)
+    {
+        out << "{\n  \"overall\": ";
+        writeGroupJson(out, "all", agg.overall);
+        out << ",\n  \"p50\": " << ranks.percentile(0.5) << ", \"p75\": " << ranks.percentile(0.75)
+            << ", \"p90\": " << ranks.percentile(0.9) << ",\n";
+        const char *sections[2] = {"departments", "grades"};
+        const map<string, GroupStats> *groups[2] = {&agg.byDepartment, &agg.byGrade};
+        for (int i = 0; i < 2; ++i)
+        {
+            out << "  \"" << sections[i] << "\": [";
+            bool first = true;
+            for (auto &g : *groups[i])
+            {
+                out << (first ? "\n    " : ",\n    ");
+                writeGroupJson(out, g.first, g.second);
+                first = false;
+            }
+            out << "\n  ]" << (i == 0 ? ",\n" : "\n");
+        }
+        out << "}\n";
+    }
+    else
+    {
+        out << "Group             Count  Mean  Range\n";
+        writeGroupText(out, "All", agg.overall);
+        char pct[96];
+        snprintf(pct, sizeof(pct), "p50 %.2f  p75 %.2f  p90 %.2f\n", ranks.percentile(0.5), ranks.percentile(0.75), ranks.percentile(0.9));
+        out << pct << "\nBy department\n";
+        for (auto &g : agg.byDepartment)
+            writeGroupText(out, g.first, g.second);
+        out << "\nBy grade\n";
+        for (auto &g : agg.byGrade)
+            writeGroupText(out, g.first, g.second);
+    }
+    if (opt.shm.empty())
+        cerr << "stats: " << rows << " rows, " << skipped << " skipped\n";
+    return 0;
+}
+
+// Ordering for compact --sort; ties keep input order
+static bool sortLess(const string &column, bool descending, const Student &a, const Student &b)
+{
+    if (descending)
+        return sortLess(column, false, b, a);
+    if (column == "name")
+        return a.name < b.name;
+    if (column == "department")
+        return a.department < b.department;
+    if (column == "grade")
+        return a.grade < b.grade;
+    if (column == "cgpa")
+        return a.cgpa < b.cgpa;
+    return a.roll < b.roll;
+}
+
+static int runCompact(const CliOptions &opt, istream &in, ostream &out)
+{
+    static constexpr size_t RUN_ROWS = 1 << 20;
+    static const char *columns[] = {"roll", "name", "department", "grade", "cgpa"};
+    bool sorting = !opt.sortColumn.empty();
+    if (sorting && find(begin(columns), end(columns), opt.sortColumn) == end(columns))
+    {
+        cerr << "compact: unknown sort column " << opt.sortColumn << "\n";
+        return 2;
+    }
+    auto less = [&](const Student &a, const Student &b)
+    { return sortLess(opt.sortColumn, opt.descending, a, b); };
+
+    RosterReader reader(in);
+    RollFilter rolls;
+    vector<Student> run;
+    vector<string> runFiles;
+    size_t written = 0;
+    // A run that can't be written or read back would drop rows silently
+    auto failRuns = [&](const string &what)
+    {
+        cerr << "compact: cannot " << what << "\n";
+        for (auto &path : runFiles)
+            remove(path.c_str());
+        return 1;
+    };
+    Student s;
+    while (reader.next(s))
+    {
+        if (!rolls.firstTime(s.roll))
+            continue;
+        s.cgpa = clampCgpa(s.cgpa);
+        if (!sorting)
+        {
+            writeStudentLine(out, s);
+            ++written;
+            continue;
+        }
+        run.push_back(s);
+        if (run.size() == RUN_ROWS)
+        {
+            // Spill a sorted run and start the next one
+            stable_sort(run.begin(), run.end(), less);
+            runFiles.push_back(opt.tmpPrefix + "." + to_string(runFiles.size()) + ".tmp");
+            ofstream f(runFiles.back());
+            for (auto &r : run)
+                writeStudentLine(f, r);
+            f.close();
+            if (!f)
+                return failRuns("write run " + runFiles.back());
+            run.clear();
+        }
+    }
+
+    if (sorting)
+    {
+        stable_sort(run.begin(), run.end(), less);
+        if (runFiles.empty())
+        {
+            for (auto &r : run)
+                writeStudentLine(out, r);
+            written = run.size();
+        }
+        else
+        {
+            // k-way merge of the spilled runs plus the in-memory tail; the
+            // run index breaks ties so equal keys keep their input order
+            size_t sources = runFiles.size() + 1;
+            vector<unique_ptr<ifstream>> files;
+            for (auto &path : runFiles)
+            {
+                files.push_back(make_unique<ifstream>(path));
+                if (!*files.back())
+                {
+                    files.clear();
+                    return failRuns("open run " + path);
+                }
+            }
+            vector<Student> head(sources);
+            size_t tailPos = 0;
+            auto advance = [&](size_t i)
+            {
+                if (i < files.size())
+                {
+                    string line;
+                    while (getline(*files[i], line))
+                        if (parseStudentLine(line, head[i]))
+                            return true;
+                    return false;
+                }
+                if (tailPos < run.size())
+                {
+                    head[i] = run[tailPos++];
+                    return true;
+                }
+                return false;
+            };
+            auto later = [&](size_t a, size_t b)
+            {
+                if (less(head[a], head[b]))
+                    return false;
+                if (less(head[b], head[a]))
+                    return true;
+                return a > b;
+            };
+            priority_queue<size_t, vector<size_t>, decltype(later)> heap(later);
+            for (size_t i = 0; i < sources; ++i)
+                if (advance(i))
+                    heap.push(i);
+            while (!heap.empty())
+            {
+                size_t i = heap.top();
+                heap.pop();
+                writeStudentLine(out, head[i]);
+                ++written;
+                if (advance(i))
+                    heap.push(i);
+            }
+            for (size_t i = 0; i < files.size(); ++i)
+                if (files[i]->bad())
+                {
+                    files.clear();
+                    return failRuns("read run " + runFiles[i]);
+                }
+            files.clear();
+            for (auto &path : runFiles)
+                remove(path.c_str());
+        }
+    }
+    cerr << "compact: " << written << " rows, " << reader.skipped << " malformed, " << rolls.duplicates << " duplicates\n";
+    return 0;
+}
+
+// ------------------------- Main -------------------------
+int main(int argc, char **argv)
+{
+    ios::sync_with_stdio(false);
+    if (argc < 2)
+    {
+        usage();
+        return 2;
+    }
+
+    CliOptions opt;
+    opt.command = argv[1];
+    bool haveInput = false;
+    for (int i = 2; i < argc; ++i)
+    {
+        string arg = argv[i];
+        string value = i + 1 < argc ? argv[i + 1] : "";
+        if (arg == "-o" || arg == "--output")
+            opt.output = value, ++i;
+        else if (arg == "--format")
+            opt.format = value, ++i;
+        else if (arg == "--sort")
+            opt.sortColumn = value, ++i;
+        else if (arg == "--tmp")
+            opt.tmpPrefix = value, ++i;
+        else if (arg == "--dedupe")
+            opt.dedupe = true;
+        else if (arg == "--desc")
+            opt.descending = true;
+        else if (arg == "--json")
+            opt.json = true;
+        // The segment name is only ever attached, so a following input path
+        // is never mistaken for it
+        else if (arg == "--shm")
+            opt.shm = "/students";
+        else if (arg.rfind("--shm=", 0) == 0)
+            opt.shm = arg.substr(6);
+        else if (opt.command == "query" && opt.expression.empty())
+            opt.expression = arg;
+        else if (!haveInput && (arg == "-" || arg[0] != '-'))
+            opt.input = arg, haveInput = true;
+        else
+        {
+            cerr << "Unknown option " << arg << "\n";
+            usage();
+            return 2;
+        }
+    }
+
+    ifstream inFile;
+    if (opt.input != "-")
+    {
+        inFile.open(opt.input);
+        if (!inFile.is_open())
+        {
+            cerr << "Cannot open " << opt.input << "\n";
+            return 1;
+        }
+    }
+    ofstream outFile;
+    if (opt.output != "-")
+    {
+        outFile.open(opt.output);
+        if (!outFile.is_open())
+        {
+            cerr << "Cannot write " << opt.output << "\n";
+            return 1;
+        }
+    }
+    istream &in = opt.input == "-" ? cin : inFile;
+    ostream &out = opt.output == "-" ? cout : outFile;
+
+    int rc;
+    if (opt.command == "import")
+        rc = runImport(opt, in, out);
+    else if (opt.command == "export")
+        rc = runExport(opt, in, out);
+    else if (opt.command == "query")
+        rc = runQuery(opt, in, out);
+    else if (opt.command == "stats")
+        rc = runStats(opt, in, out);
+    else if (opt.command == "compact")
+        rc = runCompact(opt, in, out);
+    else
+    {
+        usage();
+        return 2;
+    }
+    out.flush();
+    return rc != 0 ? rc : (out.good() ? 0 : 1);
+}
@@ -0,0 +1,309 @@
+// roster_client.h
+// Blocking client for roster_server. Each call sends one batched request and
+// waits for its response; NOTIFY frames that arrive in between only update
+// serverVersion. pollNotifications() drains them without blocking, so the GUI
+// can check once per frame whether its page of rows is stale.
+#pragma once
+#include "roster_protocol.h"
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+using namespace std;
+
+class RosterClient
+{
+public:
+    string error;
+    uint64_t serverVersion = 0; // latest version the server has reported
+    uint64_t serverSeq = 0;     // latest change-feed sequence it has reported
+    uint64_t resultSeq = 0;     // sequence the last query result reflects
+
+    ~RosterClient() { close(); }
+
+    bool connect(const string &path)
+    {
+#ifdef _WIN32
+        error = "Unix domain sockets are not supported on this platform";
+        return false;
+#else
+        close();
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_un addr = {};
+        addr.sun_family = AF_UNIX;
+        if (fd < 0 || path.size() >= sizeof(addr.sun_path))
+            return fail("cannot create socket for " + path);
+        strcpy(addr.sun_path, path.c_str());
+        if (::connect(fd, (sockaddr *)&addr, sizeof(addr)) < 0)
+            return fail("cannot connect to " + path + ": " + strerror(errno));
+        return true;
+#endif
+    }
+
+    bool connected() const { return fd >= 0; }
+
+    void close()
+    {
+#ifndef _WIN32
+        if (fd >= 0)
+            ::close(fd);
+#endif
+        fd = -1;
+        in.clear();
+        inPos = 0;
+    }
+
+    // found[i] tells whether rolls[i] exists; rows[i] is only valid if it does
+    bool get(const vector<int> &rolls, vector<Student> &rows, vector<uint8_t> &found)
+    {
+        ByteWriter w = request(OP_GET);
+        w.u32((uint32_t)rolls.size());
+        for (int roll : rolls)
+            w.i32(roll);
+        ByteReader r(nullptr, 0);
+        if (!call(w, r))
+            return false;
+        uint32_t n = r.u32();
+        rows.assign(n, Student());
+        found.assign(n, 0);
+        for (uint32_t i = 0; i < n && r.ok; ++i)
+            if ((found[i] = r.u8()))
+                rows[i] = r.student();
+        return checked(r);
+    }
+
+    bool put(const vector<Student> &rows)
+    {
+        ByteWriter w = request(OP_PUT);
+        w.u32((uint32_t)rows.size());
+        for (auto &s : rows)
+            w.student(s);
+        ByteReader r(nullptr, 0);
+        if (!call(w, r))
+            return false;
+        r.u32();
+        r.u32();
+        serverVersion = max(serverVersion, r.u64());
+        return checked(r);
+    }
+
+    // Returns the number of rows removed, or -1 on error
+    long remove(const vector<int> &rolls)
+    {
+        ByteWriter w = request(OP_DELETE);
+        w.u32((uint32_t)rolls.size());
+        for (int roll : rolls)
+            w.i32(roll);
+        ByteReader r(nullptr, 0);
+        if (!call(w, r))
+            return -1;
+        long removed = r.u32();
+        serverVersion = max(serverVersion, r.u64());
+        return checked(r) ? removed : -1;
+    }
+
+    // rows gets matches [offset, offset + limit) and total the full match
+    // count. A query the server rejects sets queryError and still returns true.
+    bool query(const string &text, uint32_t offset, uint32_t limit, vector<Student> &rows,
+               size_t &total, string *queryError = nullptr)
+    {
+        ByteWriter w = request(OP_QUERY);
+        w.str(text);
+        w.u32(offset);
+        w.u32(limit);
+        ByteReader r(nullptr, 0);
+        rows.clear();
+        total = 0;
+        if (queryError)
+            queryError->clear();
+        if (!call(w, r, queryError))
+            return queryError && !queryError->empty() && connected();
+        serverVersion = max(serverVersion, r.u64());
+        resultSeq = r.u64();
+        serverSeq = max(serverSeq, resultSeq);
+        total = r.u32();
+        uint32_t n = r.u32();
+        for (uint32_t i = 0; i < n && r.ok; ++i)
+            rows.push_back(r.student());
+        return checked(r);
+    }
+
+    bool subscribe()
+    {
+        ByteWriter w = request(OP_SUBSCRIBE);
+        ByteReader r(nullptr, 0);
+        if (!call(w, r))
+            return false;
+        serverVersion = max(serverVersion, r.u64());
+        serverSeq = max(serverSeq, r.u64());
+        return checked(r);
+    }
+
+    // Row deltas after `since`, newest per roll. complete is false when the
+    // server no longer has them and the caller has to query again.
+    bool changes(uint64_t since, vector<RowChange> &out, bool &complete)
+    {
+        ByteWriter w = request(OP_CHANGES);
+        w.u64(since);
+        ByteReader r(nullptr, 0);
+        out.clear();
+        if (!call(w, r))
+            return false;
+        serverSeq = max(serverSeq, r.u64());
+        complete = r.u8() != 0;
+        uint32_t n = r.u32();
+        for (uint32_t i = 0; i < n && r.ok; ++i)
+        {
+            RowChange c;
+            c.seq = r.u64();
+            c.kind = (RowChange::Kind)r.u8();
+            c.row = r.student();
+            out.push_back(move(c));
+        }
+        return checked(r);
+    }
+
+    // Apply any NOTIFY frames already received; never blocks
+    void pollNotifications()
+    {
+#ifndef _WIN32
+        if (fd < 0)
+            return;
+        uint8_t chunk[4096];
+        while (true)
+        {
+            ssize_t got = recv(fd, chunk, sizeof(chunk), MSG_DONTWAIT);
+            if (got > 0)
+                in.insert(in.end(), chunk, chunk + got);
+            else if (got < 0 && errno == EINTR)
+                continue;
+            else
+            {
+                if (got == 0)
+                    fail("server closed the connection");
+                break;
+            }
+        }
+        bool bad = false;
+        while (size_t len = completeFrame(in, inPos, bad))
+        {
+            ByteReader r(in.data() + inPos + 4, len - 4);
+            if (r.u8() == OP_NOTIFY)
+            {
+                r.u32();
+                serverVersion = max(serverVersion, r.u64());
+                serverSeq = max(serverSeq, r.u64());
+            }
+            inPos += len;
+        }
+        compact();
+#endif
+    }
+
+private:
+    int fd = -1;
+    uint32_t nextId = 1;
+    vector<uint8_t> out;
+    vector<uint8_t> in;
+    size_t inPos = 0;
+    vector<uint8_t> response; // payload of the last response; ByteReaders point into it
+
+    bool fail(const string &message)
+    {
+        error = message;
+        close();
+        return false;
+    }
+
+    bool checked(const ByteReader &r)
+    {
+        return r.ok || fail("malformed response from server");
+    }
+
+    void compact()
+    {
+        if (inPos > 0 && inPos * 2 >= in.size())
+        {
+            in.erase(in.begin(), in.begin() + inPos);
+            inPos = 0;
+        }
+    }
+
+    ByteWriter request(uint8_t op)
+    {
+        out.clear();
+        ByteWriter w(out);
+        w.beginFrame(op, nextId++);
+        return w;
+    }
+
+    // Send the request in `w`, wait for the matching response and leave `r`
+    // positioned after its status byte. A STATUS_ERROR reply is returned in
+    // statusError when given, otherwise in `error`.
+    bool call(ByteWriter &w, ByteReader &r, string *statusError = nullptr)
+    {
+#ifdef _WIN32
+        return fail("Unix domain sockets are not supported on this platform");
+#else
+        if (fd < 0)
+            return fail(error.empty() ? "not connected" : error);
+        w.endFrame();
+        uint8_t op = out[4];
+        uint32_t id = out[5] | (out[6] << 8) | (out[7] << 16) | ((uint32_t)out[8] << 24);
+        for (size_t sent = 0; sent < out.size();)
+        {
+            ssize_t n = send(fd, out.data() + sent, out.size() - sent, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                return fail("send failed: " + string(strerror(errno)));
+            sent += n;
+        }
+
+        uint8_t chunk[65536];
+        while (true)
+        {
+            bool bad = false;
+            while (size_t len = completeFrame(in, inPos, bad))
+            {
+                const uint8_t *frame = in.data() + inPos + 4;
+                uint8_t replyOp = frame[0];
+                ByteReader header(frame, len - 4);
+                header.u8();
+                uint32_t replyId = header.u32();
+                if (replyOp == OP_NOTIFY)
+                {
+                    serverVersion = max(serverVersion, header.u64());
+                    serverSeq = max(serverSeq, header.u64());
+                }
+                else if (replyOp == (op | RESPONSE_BIT) && replyId == id)
+                {
+                    response.assign(frame + 5, frame + len - 4);
+                    inPos += len;
+                    compact();
+                    r = ByteReader(response.data(), response.size());
+                    if (r.u8() == STATUS_OK)
+                        return true;
+                    string message = r.str();
+                    if (statusError)
+                        *statusError = message;
+                    else
+                        error = message;
+                    return false;
+                }
+                inPos += len;
+            }
+            if (bad)
+                return fail("malformed frame from server");
+            ssize_t got = recv(fd, chunk, sizeof(chunk), 0);
+            if (got < 0 && errno == EINTR)
+                continue;
+            if (got <= 0)
+                return fail("server closed the connection");
+            in.insert(in.end(), chunk, chunk + got);
+        }
+#endif
+    }
+};
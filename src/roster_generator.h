@@ -0,0 +1,105 @@
+// roster_generator.h
+// Seeded synthetic rosters for benchmarks. Uses its own RNG and sampling so
+// the same seed produces the same roster on every compiler and platform.
+#pragma once
+#include "student_manager.h"
+
+class RosterGenerator
+{
+public:
+    explicit RosterGenerator(uint64_t seed = 42, int firstRoll = 1000) : state(seed), nextRoll(firstRoll) {}
+
+    Student next()
+    {
+        Student s;
+        // Squaring the uniform skews picks toward the front of each list,
+        // so a few names are common and most are rare
+        s.name = string(pickSkewed(firstNames, FIRST_NAME_COUNT)) + " " + pickSkewed(lastNames, LAST_NAME_COUNT);
+        s.roll = nextRoll++;
+        s.department = pickWeighted();
+        s.cgpa = sampleCgpa();
+        s.grade = gradeFor(s.cgpa);
+        return s;
+    }
+
+    vector<Student> generate(size_t rows)
+    {
+        vector<Student> out;
+        out.reserve(rows);
+        for (size_t i = 0; i < rows; ++i)
+            out.push_back(next());
+        return out;
+    }
+
+    // Letter grade matching the usual 4.00 scale cut-offs
+    static const char *gradeFor(float cgpa)
+    {
+        static const float cutoffs[] = {3.75f, 3.5f, 3.25f, 3.0f, 2.75f, 2.5f, 2.25f, 2.0f};
+        static const char *grades[] = {"A+", "A", "A-", "B+", "B", "B-", "C+", "C", "F"};
+        int i = 0;
+        while (i < 8 && cgpa < cutoffs[i])
+            ++i;
+        return grades[i];
+    }
+
+private:
+    static constexpr int FIRST_NAME_COUNT = 32;
+    static constexpr int LAST_NAME_COUNT = 24;
+    static constexpr int DEPARTMENT_COUNT = 8;
+
+    static constexpr const char *firstNames[FIRST_NAME_COUNT] = {
+        "Rahim", "Karim", "Ayesha", "Nusrat", "Tanvir", "Farhana", "Sakib", "Mehedi",
+        "Sadia", "Arif", "Jannat", "Imran", "Tasnim", "Rafi", "Sumaiya", "Hasan",
+        "Nabila", "Fahim", "Rupa", "Shafiq", "Lamia", "Towhid", "Priya", "Ashik",
+        "Mitu", "Zahid", "Sharmin", "Ovi", "Keya", "Polash", "Dipu", "Anika"};
+    static constexpr const char *lastNames[LAST_NAME_COUNT] = {
+        "Rahman", "Hossain", "Islam", "Ahmed", "Khan", "Chowdhury", "Akter", "Uddin",
+        "Sarkar", "Das", "Miah", "Roy", "Begum", "Haque", "Sultana", "Kabir",
+        "Alam", "Talukder", "Bhuiyan", "Sheikh", "Paul", "Mondal", "Saha", "Karim"};
+    static constexpr const char *departments[DEPARTMENT_COUNT] = {
+        "CSE", "EEE", "BBA", "CE", "ME", "English", "Law", "Pharmacy"};
+    static constexpr int departmentWeights[DEPARTMENT_COUNT] = {30, 18, 15, 10, 9, 7, 6, 5};
+
+    uint64_t state;
+    int nextRoll;
+
+    // splitmix64
+    uint64_t nextBits()
+    {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    double uniform() { return (nextBits() >> 11) * (1.0 / 9007199254740992.0); }
+
+    const char *pickSkewed(const char *const *list, int count)
+    {
+        double u = uniform();
+        return list[(int)(u * u * count)];
+    }
+
+    const char *pickWeighted()
+    {
+        int r = (int)(uniform() * 100);
+        for (int i = 0; i < DEPARTMENT_COUNT; ++i)
+        {
+            if (r < departmentWeights[i])
+                return departments[i];
+            r -= departmentWeights[i];
+        }
+        return departments[DEPARTMENT_COUNT - 1];
+    }
+
+    // Normal(3.1, 0.45) by Box-Muller, clamped to the scale and rounded to 0.01
+    float sampleCgpa()
+    {
+        double u1 = uniform(), u2 = uniform();
+        if (u1 < 1e-12)
+            u1 = 1e-12;
+        double z = sqrt(-2.0 * log(u1)) * cos(6.283185307179586 * u2);
+        double cgpa = min(4.0, max(0.0, 3.1 + 0.45 * z));
+        return (float)(lround(cgpa * 100) / 100.0);
+    }
+};
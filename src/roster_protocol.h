@@ -0,0 +1,212 @@
+// roster_protocol.h
+// Binary request/response framing shared by roster_server and RosterClient.
+// Every frame is
+//
+//   u32 size    bytes that follow this field
+//   u8  op      RosterOp; responses have RESPONSE_BIT set
+//   u32 id      chosen by the client and echoed in the response (0 for NOTIFY)
+//   ...         payload
+//
+// Integers are little-endian, strings are a u16 length followed by the bytes,
+// and a student is i32 roll, f32 cgpa, then name, grade and department.
+// Every response payload starts with a u8 RosterStatus; ERROR is followed by
+// a message string.
+//
+//   GET       u32 n, n x i32 roll          -> u32 n, n x (u8 found, [student])
+//   PUT       u32 n, n x student           -> u32 added, u32 updated, u64 version  (upsert by roll)
+//   DELETE    u32 n, n x i32 roll          -> u32 removed, u64 version
+//   QUERY     str text, u32 offset, u32 limit
+//                                          -> u64 version, u64 seq, u32 total, u32 n, n x student
+//   SUBSCRIBE                              -> u64 version, u64 seq, then NOTIFY frames
+//   CHANGES   u64 since                    -> u64 seq, u8 complete, u32 n,
+//                                             n x (u64 seq, u8 RowChange::Kind, student)
+//   NOTIFY    (server to client) u64 version, u64 seq after each batch of changes
+//
+// `seq` is the server's ChangeFeed sequence. CHANGES returns the row deltas
+// after `since`; complete = 0 (with no rows) means they are gone and the
+// client has to query again.
+#pragma once
+#include "student_manager.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstring>
+using namespace std;
+
+enum RosterOp : uint8_t
+{
+    OP_GET = 1,
+    OP_PUT = 2,
+    OP_DELETE = 3,
+    OP_QUERY = 4,
+    OP_SUBSCRIBE = 5,
+    OP_NOTIFY = 6,
+    OP_CHANGES = 7,
+    RESPONSE_BIT = 0x80
+};
+
+enum RosterStatus : uint8_t
+{
+    STATUS_OK = 0,
+    STATUS_ERROR = 1
+};
+
+static constexpr uint32_t FRAME_HEADER = 9;          // size + op + id
+static constexpr uint32_t MAX_FRAME = 64 << 20;      // larger frames close the connection
+static constexpr const char *DEFAULT_SOCKET = "students.sock";
+
+// Appends frames to a byte buffer
+class ByteWriter
+{
+public:
+    vector<uint8_t> &buf;
+
+    explicit ByteWriter(vector<uint8_t> &buf) : buf(buf) {}
+
+    void beginFrame(uint8_t op, uint32_t id)
+    {
+        frameStart = buf.size();
+        u32(0); // patched by endFrame
+        u8(op);
+        u32(id);
+    }
+
+    void endFrame()
+    {
+        uint32_t size = (uint32_t)(buf.size() - frameStart - 4);
+        for (int i = 0; i < 4; ++i)
+            buf[frameStart + i] = (uint8_t)(size >> (8 * i));
+    }
+
+    void u8(uint8_t v) { buf.push_back(v); }
+
+    void u32(uint32_t v)
+    {
+        for (int i = 0; i < 4; ++i)
+            buf.push_back((uint8_t)(v >> (8 * i)));
+    }
+
+    void u64(uint64_t v)
+    {
+        for (int i = 0; i < 8; ++i)
+            buf.push_back((uint8_t)(v >> (8 * i)));
+    }
+
+    void i32(int32_t v) { u32((uint32_t)v); }
+
+    void f32(float v)
+    {
+        uint32_t bits;
+        memcpy(&bits, &v, 4);
+        u32(bits);
+    }
+
+    void str(const string &s)
+    {
+        uint16_t n = (uint16_t)min<size_t>(s.size(), 0xFFFF);
+        buf.push_back((uint8_t)n);
+        buf.push_back((uint8_t)(n >> 8));
+        buf.insert(buf.end(), s.begin(), s.begin() + n);
+    }
+
+    void student(const Student &s)
+    {
+        i32(s.roll);
+        f32(s.cgpa);
+        str(s.name);
+        str(s.grade);
+        str(s.department);
+    }
+
+private:
+    size_t frameStart = 0;
+};
+
+// Reads a payload; any read past the end clears `ok` and returns zeros
+class ByteReader
+{
+public:
+    const uint8_t *p;
+    const uint8_t *end;
+    bool ok = true;
+
+    ByteReader(const uint8_t *data, size_t size) : p(data), end(data + size) {}
+
+    bool has(size_t n)
+    {
+        if ((size_t)(end - p) >= n)
+            return true;
+        ok = false;
+        p = end;
+        return false;
+    }
+
+    uint8_t u8() { return has(1) ? *p++ : 0; }
+
+    uint32_t u32()
+    {
+        if (!has(4))
+            return 0;
+        uint32_t v = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+        p += 4;
+        return v;
+    }
+
+    uint64_t u64()
+    {
+        uint64_t lo = u32();
+        return lo | ((uint64_t)u32() << 32);
+    }
+
+    int32_t i32() { return (int32_t)u32(); }
+
+    float f32()
+    {
+        uint32_t bits = u32();
+        float v;
+        memcpy(&v, &bits, 4);
+        return v;
+    }
+
+    string str()
+    {
+        if (!has(2))
+            return "";
+        size_t n = p[0] | (p[1] << 8);
+        p += 2;
+        if (!has(n))
+            return "";
+        string s((const char *)p, n);
+        p += n;
+        return s;
+    }
+
+    Student student()
+    {
+        Student s;
+        s.roll = i32();
+        s.cgpa = f32();
+        s.name = str();
+        s.grade = str();
+        s.department = str();
+        return s;
+    }
+};
+
+// Length of the first complete frame in buf[from..), or 0 if more bytes are
+// needed. Frames over MAX_FRAME or under the header size set `bad`.
+inline size_t completeFrame(const vector<uint8_t> &buf, size_t from, bool &bad)
+{
+    bad = false;
+    if (buf.size() - from < 4)
+        return 0;
+    uint32_t size = buf[from] | (buf[from + 1] << 8) | (buf[from + 2] << 16) | ((uint32_t)buf[from + 3] << 24);
+    if (size > MAX_FRAME || size < FRAME_HEADER - 4)
+    {
+        bad = true;
+        return 0;
+    }
+    if (buf.size() - from < 4 + (size_t)size)
+        return 0;
+    return 4 + (size_t)size;
+}
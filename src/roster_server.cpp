@@ -0,0 +1,497 @@
+// roster_server.cpp
+// Daemon that owns the one in-memory StudentManager and serves it to GUI
+// clients and tools over a Unix domain socket (see roster_protocol.h).
+// Linux only: a single thread drives every connection with epoll.
+//
+//   roster_server [--socket students.sock] [--data students.txt] [--flush-ms 1000]
+//                 [--publish [/students]]
+//
+// Changes are written back to the data file at most once per --flush-ms and
+// on SIGINT/SIGTERM, so clients never load or save the file themselves.
+// --publish also maps each saved state into shared memory for reporting
+// tools (see roster_snapshot.h).
+#include "roster_protocol.h"
+#include "roster_snapshot.h"
+#include <iostream>
+#include <chrono>
+#include <csignal>
+#include <cerrno>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <fcntl.h>
+using namespace std;
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void onSignal(int) { stopRequested = 1; }
+
+class Connection
+{
+public:
+    int fd = -1;
+    vector<uint8_t> in;
+    size_t inPos = 0; // first unparsed byte of `in`
+    vector<uint8_t> out;
+    size_t outPos = 0; // first unsent byte of `out`
+    bool subscribed = false;
+    bool wantWrite = false; // EPOLLOUT registered
+};
+
+class RosterServer
+{
+public:
+    StudentManager manager;
+    string dataPath = "students.txt";
+    string socketPath = DEFAULT_SOCKET;
+    int flushMs = 1000;
+    bool publishing = false;
+    SnapshotPublisher publisher;
+
+    uint64_t requests = 0;
+
+    bool start()
+    {
+        manager.load(dataPath);
+        savedVersion = notifiedVersion = manager.version;
+        if (publishing && !publisher.publish(manager))
+        {
+            cerr << publisher.error << "\n";
+            return false;
+        }
+
+        listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listenFd < 0)
+            return fail("socket");
+        sockaddr_un addr = {};
+        addr.sun_family = AF_UNIX;
+        if (socketPath.size() >= sizeof(addr.sun_path))
+        {
+            cerr << "Socket path too long: " << socketPath << "\n";
+            return false;
+        }
+        strcpy(addr.sun_path, socketPath.c_str());
+        unlink(socketPath.c_str()); // stale socket from a previous run
+        if (bind(listenFd, (sockaddr *)&addr, sizeof(addr)) < 0)
+            return fail("bind");
+        if (listen(listenFd, 128) < 0)
+            return fail("listen");
+
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        if (epollFd < 0)
+            return fail("epoll_create1");
+        epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.ptr = nullptr; // the listening socket
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &ev);
+        cerr << "roster_server: " << manager.students.size() << " students from " << dataPath
+             << ", listening on " << socketPath << "\n";
+        return true;
+    }
+
+    void run()
+    {
+        epoll_event events[64];
+        lastFlush = chrono::steady_clock::now();
+        while (!stopRequested)
+        {
+            int n = epoll_wait(epollFd, events, 64, flushMs);
+            if (n < 0 && errno != EINTR)
+            {
+                perror("epoll_wait");
+                break;
+            }
+            for (int i = 0; i < n; ++i)
+            {
+                Connection *c = (Connection *)events[i].data.ptr;
+                if (!c)
+                {
+                    acceptAll();
+                    continue;
+                }
+                bool alive = !(events[i].events & (EPOLLHUP | EPOLLERR));
+                if (alive && (events[i].events & EPOLLIN))
+                    alive = readFrom(c);
+                if (alive && (events[i].events & EPOLLOUT))
+                    alive = flush(c);
+                if (!alive)
+                    closeConnection(c);
+            }
+            notifySubscribers();
+            flushChanges(false);
+        }
+        flushChanges(true);
+    }
+
+    void shutdown()
+    {
+        for (Connection *c : connections)
+        {
+            ::close(c->fd);
+            delete c;
+        }
+        connections.clear();
+        if (listenFd >= 0)
+            ::close(listenFd);
+        if (epollFd >= 0)
+            ::close(epollFd);
+        unlink(socketPath.c_str());
+        if (publishing)
+            publisher.unpublish();
+    }
+
+private:
+    int listenFd = -1;
+    int epollFd = -1;
+    vector<Connection *> connections;
+    uint64_t savedVersion = 0;
+    uint64_t notifiedVersion = 0;
+    chrono::steady_clock::time_point lastFlush;
+
+    // Result of the last QUERY, so paging through it costs O(limit)
+    string cachedQuery;
+    uint64_t cachedVersion = ~0ULL;
+    vector<Student *> cachedRows;
+    string cachedError;
+
+    vector<RowChange> changeBatch; // reused by every CHANGES request
+
+    static bool fail(const char *what)
+    {
+        perror(what);
+        return false;
+    }
+
+    void acceptAll()
+    {
+        while (true)
+        {
+            int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0)
+                return;
+            Connection *c = new Connection;
+            c->fd = fd;
+            connections.push_back(c);
+            epoll_event ev = {};
+            ev.events = EPOLLIN;
+            ev.data.ptr = c;
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+        }
+    }
+
+    void closeConnection(Connection *c)
+    {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, c->fd, nullptr);
+        ::close(c->fd);
+        connections.erase(find(connections.begin(), connections.end(), c));
+        delete c;
+    }
+
+    // Answer every complete frame after each chunk read, so at most one
+    // partial frame is buffered, and give up the thread after READ_BUDGET
+    // bytes; epoll is level-triggered and reports the rest on the next wait
+    bool readFrom(Connection *c)
+    {
+        static constexpr size_t READ_BUDGET = 1 << 20;
+        uint8_t chunk[65536];
+        ByteWriter w(c->out);
+        for (size_t total = 0; total < READ_BUDGET;)
+        {
+            ssize_t got = read(c->fd, chunk, sizeof(chunk));
+            if (got == 0)
+                return false;
+            if (got < 0)
+            {
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                    break;
+                if (errno != EINTR)
+                    return false;
+                continue;
+            }
+            total += (size_t)got;
+            c->in.insert(c->in.end(), chunk, chunk + got);
+
+            bool bad = false;
+            while (size_t len = completeFrame(c->in, c->inPos, bad))
+            {
+                ByteReader r(c->in.data() + c->inPos + 4, len - 4);
+                uint8_t op = r.u8();
+                uint32_t id = r.u32();
+                handle(c, op, id, r, w);
+                c->inPos += len;
+                ++requests;
+            }
+            if (bad)
+                return false;
+            // Drop consumed bytes once they dominate the buffer
+            if (c->inPos > 0 && c->inPos * 2 >= c->in.size())
+            {
+                c->in.erase(c->in.begin(), c->in.begin() + c->inPos);
+                c->inPos = 0;
+            }
+        }
+        return flush(c);
+    }
+
+    void handle(Connection *c, uint8_t op, uint32_t id, ByteReader &r, ByteWriter &w)
+    {
+        w.beginFrame(op | RESPONSE_BIT, id);
+        switch (op)
+        {
+        case OP_GET:
+        {
+            uint32_t n = r.u32();
+            vector<int> rolls;
+            for (uint32_t i = 0; i < n && r.ok; ++i)
+                rolls.push_back(r.i32());
+            if (!r.ok)
+                break;
+            w.u8(STATUS_OK);
+            w.u32((uint32_t)rolls.size());
+            for (int roll : rolls)
+            {
+                Student *s = manager.findByRoll(roll);
+                w.u8(s ? 1 : 0);
+                if (s)
+                    w.student(*s);
+            }
+            w.endFrame();
+            return;
+        }
+        case OP_PUT:
+        {
+            uint32_t n = r.u32();
+            vector<Student> rows;
+            for (uint32_t i = 0; i < n && r.ok; ++i)
+                rows.push_back(r.student());
+            if (!r.ok)
+                break;
+            uint32_t added = 0, updated = 0;
+            for (auto &s : rows)
+            {
+                cleanStudentFields(s);
+                if (Student *existing = manager.findByRoll(s.roll))
+                {
+                    manager.update(existing, s);
+                    ++updated;
+                }
+                else
+                {
+                    manager.add(s);
+                    ++added;
+                }
+            }
+            w.u8(STATUS_OK);
+            w.u32(added);
+            w.u32(updated);
+            w.u64(manager.version);
+            w.endFrame();
+            return;
+        }
+        case OP_DELETE:
+        {
+            uint32_t n = r.u32();
+            vector<int> rolls;
+            for (uint32_t i = 0; i < n && r.ok; ++i)
+                rolls.push_back(r.i32());
+            if (!r.ok)
+                break;
+            w.u8(STATUS_OK);
+            w.u32((uint32_t)manager.removeRolls(rolls));
+            w.u64(manager.version);
+            w.endFrame();
+            return;
+        }
+        case OP_QUERY:
+        {
+            string text = r.str();
+            uint32_t offset = r.u32();
+            uint32_t limit = r.u32();
+            if (!r.ok)
+                break;
+            if (text != cachedQuery || manager.version != cachedVersion)
+            {
+                QueryPlan plan;
+                cachedRows = manager.query(text, &plan);
+                cachedError = plan.error;
+                cachedQuery = text;
+                cachedVersion = manager.version;
+            }
+            if (!cachedError.empty())
+            {
+                w.u8(STATUS_ERROR);
+                w.str(cachedError);
+                w.endFrame();
+                return;
+            }
+            size_t total = cachedRows.size();
+            size_t first = min<size_t>(offset, total);
+            size_t count = min<size_t>(limit, total - first);
+            w.u8(STATUS_OK);
+            w.u64(manager.version);
+            w.u64(manager.changes.lastSeq);
+            w.u32((uint32_t)total);
+            w.u32((uint32_t)count);
+            for (size_t i = first; i < first + count; ++i)
+                w.student(*cachedRows[i]);
+            w.endFrame();
+            return;
+        }
+        case OP_SUBSCRIBE:
+            c->subscribed = true;
+            w.u8(STATUS_OK);
+            w.u64(manager.version);
+            w.u64(manager.changes.lastSeq);
+            w.endFrame();
+            return;
+        case OP_CHANGES:
+        {
+            uint64_t since = r.u64();
+            if (!r.ok)
+                break;
+            changeBatch.clear();
+            bool complete = manager.changes.since(since, changeBatch);
+            w.u8(STATUS_OK);
+            w.u64(manager.changes.lastSeq);
+            w.u8(complete ? 1 : 0);
+            w.u32((uint32_t)changeBatch.size());
+            for (auto &change : changeBatch)
+            {
+                w.u64(change.seq);
+                w.u8(change.kind);
+                w.student(change.row);
+            }
+            w.endFrame();
+            return;
+        }
+        default:
+            w.u8(STATUS_ERROR);
+            w.str("unknown op");
+            w.endFrame();
+            return;
+        }
+        w.u8(STATUS_ERROR);
+        w.str("malformed request");
+        w.endFrame();
+    }
+
+    bool flush(Connection *c)
+    {
+        while (c->outPos < c->out.size())
+        {
+            ssize_t sent = send(c->fd, c->out.data() + c->outPos, c->out.size() - c->outPos, MSG_NOSIGNAL);
+            if (sent > 0)
+                c->outPos += sent;
+            else if (sent < 0 && errno == EINTR)
+                continue;
+            else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                break;
+            else
+                return false;
+        }
+        if (c->outPos == c->out.size())
+        {
+            c->out.clear();
+            c->outPos = 0;
+        }
+        // Only ask for EPOLLOUT while there is something left to send
+        bool pending = !c->out.empty();
+        if (pending != c->wantWrite)
+        {
+            epoll_event ev = {};
+            ev.events = EPOLLIN | (pending ? (uint32_t)EPOLLOUT : 0u);
+            ev.data.ptr = c;
+            epoll_ctl(epollFd, EPOLL_CTL_MOD, c->fd, &ev);
+            c->wantWrite = pending;
+        }
+        return true;
+    }
+
+    // One NOTIFY per readiness batch, however many changes it made
+    void notifySubscribers()
+    {
+        if (manager.version == notifiedVersion)
+            return;
+        notifiedVersion = manager.version;
+        vector<Connection *> dead;
+        for (Connection *c : connections)
+        {
+            if (!c->subscribed)
+                continue;
+            ByteWriter w(c->out);
+            w.beginFrame(OP_NOTIFY, 0);
+            w.u64(notifiedVersion);
+            w.u64(manager.changes.lastSeq);
+            w.endFrame();
+            if (!flush(c))
+                dead.push_back(c);
+        }
+        for (Connection *c : dead)
+            closeConnection(c);
+    }
+
+    // Save, and publish a snapshot, at most once per flushMs
+    void flushChanges(bool force)
+    {
+        auto now = chrono::steady_clock::now();
+        if (manager.version == savedVersion)
+            return;
+        if (!force && chrono::duration_cast<chrono::milliseconds>(now - lastFlush).count() < flushMs)
+            return;
+        manager.save(dataPath);
+        if (publishing && !publisher.publish(manager))
+            cerr << "roster_server: " << publisher.error << "\n";
+        savedVersion = manager.version;
+        lastFlush = now;
+    }
+};
+
+int main(int argc, char **argv)
+{
+    RosterServer server;
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        string value = i + 1 < argc ? argv[i + 1] : "";
+        if (arg == "--socket")
+            server.socketPath = value, ++i;
+        else if (arg == "--data")
+            server.dataPath = value, ++i;
+        else if (arg == "--publish")
+        {
+            server.publishing = true;
+            if (!value.empty() && value[0] == '/')
+                server.publisher.name = value, ++i;
+        }
+        else if (arg == "--flush-ms")
+        {
+            try
+            {
+                server.flushMs = max(10, stoi(value));
+            }
+            catch (...)
+            {
+                cerr << "Bad --flush-ms value\n";
+                return 2;
+            }
+            ++i;
+        }
+        else
+        {
+            cerr << "Usage: roster_server [--socket students.sock] [--data students.txt] [--flush-ms 1000]\n"
+                 << "                     [--publish [/students]]\n";
+            return 2;
+        }
+    }
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    signal(SIGPIPE, SIG_IGN);
+    if (!server.start())
+        return 1;
+    server.run();
+    server.shutdown();
+    cerr << "roster_server: " << server.requests << " requests served, saved to " << server.dataPath << "\n";
+    return 0;
+}
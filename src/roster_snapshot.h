@@ -0,0 +1,315 @@
+// roster_snapshot.h
+// Read-only roster snapshots in POSIX shared memory, so reporting tools on the
+// same host can read the roster a server or GUI already holds without parsing
+// students.txt again.
+//
+// A publisher writes each snapshot once into its own segment "<name>.<epoch>"
+// and never touches it again, then bumps the epoch in the control segment
+// "<name>". Readers map the segment for the current epoch and read it in
+// place; stale() tells them a newer one exists. The publisher unlinks the
+// segment two epochs back, so a reader that just read the epoch still finds
+// its segment, and mappings stay valid after an unlink.
+//
+// Everything inside a segment is addressed by offsets from its start, so it
+// maps at any address:
+//   SnapshotHeader
+//   i32   roll[rows]
+//   f32   cgpa[rows]
+//   u32   name[rows + 1], grade[rows + 1], department[rows + 1]   offsets into text
+//   char  text[]
+//
+// POSIX only (shm_open/mmap).
+#pragma once
+#include "student_manager.h"
+#include <atomic>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+using namespace std;
+
+static constexpr char SNAPSHOT_MAGIC[8] = {'R', 'S', 'N', 'A', 'P', 'S', 'H', '1'};
+static constexpr const char *DEFAULT_SNAPSHOT = "/students";
+
+class SnapshotControl
+{
+public:
+    char magic[8];
+    atomic<uint64_t> epoch; // newest complete snapshot; 0 before the first
+};
+
+class SnapshotHeader
+{
+public:
+    char magic[8];
+    uint64_t epoch;
+    uint64_t version; // StudentManager::version it was taken at
+    uint64_t rows;
+    uint64_t rollOffset, cgpaOffset;
+    uint64_t nameOffset, gradeOffset, departmentOffset;
+    uint64_t textOffset, textSize;
+    uint64_t totalSize;
+};
+
+inline string snapshotSegment(const string &name, uint64_t epoch)
+{
+    return name + "." + to_string(epoch);
+}
+
+// Round up so every column starts 8-byte aligned
+inline uint64_t snapshotAlign(uint64_t n) { return (n + 7) & ~(uint64_t)7; }
+
+class SnapshotPublisher
+{
+public:
+    string name = DEFAULT_SNAPSHOT;
+    string error;
+    uint64_t epoch = 0; // last one published
+
+    ~SnapshotPublisher() { unmapControl(); }
+
+    bool publish(const StudentManager &manager)
+    {
+        TRACE_SPAN("publishSnapshot");
+        if (!control && !openControl())
+            return false;
+
+        const vector<Student> &students = manager.students;
+        uint64_t rows = students.size();
+        uint64_t text = 0;
+        for (auto &s : students)
+            text += s.name.size() + s.grade.size() + s.department.size();
+        if (text > UINT32_MAX)
+            return fail("roster text too large for a snapshot");
+
+        SnapshotHeader h = {};
+        memcpy(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic));
+        h.epoch = control->epoch.load(memory_order_acquire) + 1;
+        h.version = manager.version;
+        h.rows = rows;
+        h.rollOffset = snapshotAlign(sizeof(SnapshotHeader));
+        h.cgpaOffset = snapshotAlign(h.rollOffset + rows * sizeof(int32_t));
+        h.nameOffset = snapshotAlign(h.cgpaOffset + rows * sizeof(float));
+        h.gradeOffset = snapshotAlign(h.nameOffset + (rows + 1) * sizeof(uint32_t));
+        h.departmentOffset = snapshotAlign(h.gradeOffset + (rows + 1) * sizeof(uint32_t));
+        h.textOffset = snapshotAlign(h.departmentOffset + (rows + 1) * sizeof(uint32_t));
+        h.textSize = text;
+        h.totalSize = h.textOffset + text;
+
+        string segment = snapshotSegment(name, h.epoch);
+        shm_unlink(segment.c_str()); // left over from a publisher that died mid-write
+        int fd = shm_open(segment.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0)
+            return fail("shm_open " + segment + ": " + strerror(errno));
+        void *mem = MAP_FAILED;
+        if (ftruncate(fd, (off_t)h.totalSize) == 0)
+            mem = mmap(nullptr, h.totalSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mem == MAP_FAILED)
+        {
+            shm_unlink(segment.c_str());
+            return fail("cannot map " + segment + ": " + strerror(errno));
+        }
+
+        char *base = (char *)mem;
+        memcpy(base, &h, sizeof(h));
+        int32_t *roll = (int32_t *)(base + h.rollOffset);
+        float *cgpa = (float *)(base + h.cgpaOffset);
+        uint32_t *nameAt = (uint32_t *)(base + h.nameOffset);
+        uint32_t *gradeAt = (uint32_t *)(base + h.gradeOffset);
+        uint32_t *departmentAt = (uint32_t *)(base + h.departmentOffset);
+        char *out = base + h.textOffset;
+        uint32_t pos = 0;
+        auto put = [&](const string &s)
+        {
+            memcpy(out + pos, s.data(), s.size());
+            pos += (uint32_t)s.size();
+        };
+        // Each string column ends where the next row's starts; the three
+        // columns are laid out back to back in text
+        for (uint64_t i = 0; i < rows; ++i)
+        {
+            roll[i] = students[i].roll;
+            cgpa[i] = students[i].cgpa;
+            nameAt[i] = pos;
+            put(students[i].name);
+        }
+        nameAt[rows] = pos;
+        for (uint64_t i = 0; i < rows; ++i)
+        {
+            gradeAt[i] = pos;
+            put(students[i].grade);
+        }
+        gradeAt[rows] = pos;
+        for (uint64_t i = 0; i < rows; ++i)
+        {
+            departmentAt[i] = pos;
+            put(students[i].department);
+        }
+        departmentAt[rows] = pos;
+        munmap(mem, h.totalSize);
+
+        // Readers only ever see complete snapshots
+        control->epoch.store(h.epoch, memory_order_release);
+        if (h.epoch > 2)
+            shm_unlink(snapshotSegment(name, h.epoch - 2).c_str());
+        epoch = h.epoch;
+        return true;
+    }
+
+    // Remove the control segment and the snapshots still linked; mapped
+    // readers keep their copy
+    void unpublish()
+    {
+        for (uint64_t e = epoch > 1 ? epoch - 1 : 1; e <= epoch; ++e)
+            shm_unlink(snapshotSegment(name, e).c_str());
+        shm_unlink(name.c_str());
+        unmapControl();
+    }
+
+private:
+    SnapshotControl *control = nullptr;
+
+    bool fail(const string &message)
+    {
+        error = message;
+        return false;
+    }
+
+    bool openControl()
+    {
+        int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+        if (fd < 0)
+            return fail("shm_open " + name + ": " + strerror(errno));
+        struct stat st;
+        bool fresh = fstat(fd, &st) == 0 && st.st_size == 0;
+        void *mem = MAP_FAILED;
+        if (!fresh || ftruncate(fd, sizeof(SnapshotControl)) == 0)
+            mem = mmap(nullptr, sizeof(SnapshotControl), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mem == MAP_FAILED)
+            return fail("cannot map " + name + ": " + strerror(errno));
+        control = (SnapshotControl *)mem;
+        // A new segment is zero-filled; an existing one keeps counting up so
+        // readers never mistake a new snapshot for one they have
+        if (memcmp(control->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0)
+        {
+            control->epoch.store(0, memory_order_relaxed);
+            memcpy(control->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+        }
+        return true;
+    }
+
+    void unmapControl()
+    {
+        if (control)
+            munmap(control, sizeof(SnapshotControl));
+        control = nullptr;
+    }
+};
+
+class RosterSnapshot
+{
+public:
+    string error;
+
+    ~RosterSnapshot() { close(); }
+
+    // Map the newest snapshot published under `name`
+    bool open(const string &name = DEFAULT_SNAPSHOT)
+    {
+        close();
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0)
+            return fail("no snapshot published as " + name);
+        void *mem = mmap(nullptr, sizeof(SnapshotControl), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mem == MAP_FAILED)
+            return fail("cannot map " + name);
+        control = (const SnapshotControl *)mem;
+        if (memcmp(control->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0)
+            return fail(name + " is not a roster snapshot");
+
+        // The publisher may move on between reading the epoch and opening its
+        // segment; it keeps the previous one around, so a retry settles it
+        for (int attempt = 0; attempt < 3; ++attempt)
+        {
+            uint64_t epoch = control->epoch.load(memory_order_acquire);
+            if (epoch == 0)
+                return fail("nothing published yet as " + name);
+            if (mapSegment(snapshotSegment(name, epoch)))
+                return true;
+        }
+        return fail("snapshot " + name + " keeps changing");
+    }
+
+    // A newer snapshot has been published since this one was mapped
+    bool stale() const { return control && header && control->epoch.load(memory_order_acquire) != header->epoch; }
+
+    void close()
+    {
+        if (header)
+            munmap((void *)header, header->totalSize);
+        if (control)
+            munmap((void *)control, sizeof(SnapshotControl));
+        header = nullptr;
+        control = nullptr;
+    }
+
+    uint64_t epoch() const { return header ? header->epoch : 0; }
+    uint64_t version() const { return header ? header->version : 0; }
+    size_t rows() const { return header ? (size_t)header->rows : 0; }
+
+    int32_t roll(size_t i) const { return column<int32_t>(header->rollOffset)[i]; }
+    float cgpa(size_t i) const { return column<float>(header->cgpaOffset)[i]; }
+    string_view name(size_t i) const { return text(header->nameOffset, i); }
+    string_view grade(size_t i) const { return text(header->gradeOffset, i); }
+    string_view department(size_t i) const { return text(header->departmentOffset, i); }
+
+private:
+    const SnapshotControl *control = nullptr;
+    const SnapshotHeader *header = nullptr;
+
+    bool fail(const string &message)
+    {
+        error = message;
+        close();
+        return false;
+    }
+
+    bool mapSegment(const string &segment)
+    {
+        int fd = shm_open(segment.c_str(), O_RDONLY, 0);
+        if (fd < 0)
+            return false;
+        struct stat st;
+        void *mem = MAP_FAILED;
+        if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(SnapshotHeader))
+            mem = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mem == MAP_FAILED)
+            return false;
+        const SnapshotHeader *h = (const SnapshotHeader *)mem;
+        if (memcmp(h->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 || h->totalSize != (uint64_t)st.st_size)
+        {
+            munmap(mem, st.st_size);
+            return false;
+        }
+        header = h;
+        return true;
+    }
+
+    template <typename T>
+    const T *column(uint64_t offset) const
+    {
+        return (const T *)((const char *)header + offset);
+    }
+
+    string_view text(uint64_t offsets, size_t i) const
+    {
+        const uint32_t *at = column<uint32_t>(offsets);
+        return string_view((const char *)header + header->textOffset + at[i], at[i + 1] - at[i]);
+    }
+};
@@ -0,0 +1,129 @@
+// roster_table_view.h
+// Dear ImGui view of the roster: the search box, a status line and one table.
+// ImGuiListClipper submits only the rows in view, so a frame costs the same
+// for 5,000 rows as for 10 million. Header clicks go through the table's sort
+// specs to StudentManager::sortBy; columns can be resized, reordered and hidden.
+// Per-row labels are formatted into the caller's FrameArena, never the heap.
+#pragma once
+#include "imgui.h"
+#include "student_manager.h"
+#include "frame_arena.h"
+#include <cfloat>
+using namespace std;
+
+class RosterTableView
+{
+public:
+    char search[256] = "";
+    int selectedRoll = -1;
+    int submittedRows = 0; // rows the clipper submitted last frame
+
+    vector<Student *> visible;
+    QueryPlan plan;
+
+    void draw(StudentManager &manager, FrameArena &arena)
+    {
+        ImGui::SetNextItemWidth(-FLT_MIN);
+        ImGui::InputTextWithHint("##search", "Search (dept:CSE cgpa>=3.5 name~...)", search, sizeof(search));
+        refresh(manager);
+
+        if (!plan.error.empty())
+            ImGui::TextColored(ImVec4(1.0f, 0.45f, 0.4f, 1.0f), "Query error: %s", plan.error.c_str());
+        else
+            ImGui::TextUnformatted(arena.format("%zu of %zu rows  |  %s  %.2f ms  |  %.0f FPS", visible.size(),
+                                                manager.students.size(), plan.plan.c_str(), plan.totalMs(),
+                                                ImGui::GetIO().Framerate));
+
+        const ImGuiTableFlags flags = ImGuiTableFlags_Resizable | ImGuiTableFlags_Reorderable | ImGuiTableFlags_Hideable |
+                                      ImGuiTableFlags_Sortable | ImGuiTableFlags_SortTristate | ImGuiTableFlags_RowBg |
+                                      ImGuiTableFlags_BordersOuter | ImGuiTableFlags_BordersV | ImGuiTableFlags_ScrollY |
+                                      ImGuiTableFlags_SizingFixedFit;
+        if (!ImGui::BeginTable("roster", 5, flags, ImVec2(0.0f, -ImGui::GetFrameHeightWithSpacing())))
+            return;
+        ImGui::TableSetupScrollFreeze(0, 1);
+        // The column user ID is the SortColumn it sorts by
+        ImGui::TableSetupColumn("Roll", ImGuiTableColumnFlags_WidthFixed, 90.0f, (ImGuiID)SortColumn::ROLL);
+        ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_WidthStretch, 0.0f, (ImGuiID)SortColumn::NAME);
+        ImGui::TableSetupColumn("Department", ImGuiTableColumnFlags_WidthFixed, 140.0f, (ImGuiID)SortColumn::DEPARTMENT);
+        ImGui::TableSetupColumn("Grade", ImGuiTableColumnFlags_WidthFixed, 70.0f, (ImGuiID)SortColumn::GRADE);
+        ImGui::TableSetupColumn("CGPA", ImGuiTableColumnFlags_WidthFixed, 70.0f, (ImGuiID)SortColumn::CGPA);
+        ImGui::TableHeadersRow();
+
+        if (ImGuiTableSortSpecs *specs = ImGui::TableGetSortSpecs())
+        {
+            if (specs->SpecsDirty)
+            {
+                // No spec (third click) keeps the current order
+                if (specs->SpecsCount > 0)
+                {
+                    const ImGuiTableColumnSortSpecs &s = specs->Specs[0];
+                    manager.sortBy((SortColumn)s.ColumnUserID, s.SortDirection == ImGuiSortDirection_Ascending);
+                    refresh(manager);
+                }
+                specs->SpecsDirty = false;
+            }
+        }
+
+        submittedRows = 0;
+        ImGuiListClipper clipper;
+        clipper.Begin((int)visible.size());
+        while (clipper.Step())
+        {
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+            {
+                const Student &s = *visible[i];
+                ImGui::TableNextRow();
+                ImGui::PushID(i);
+
+                ImGui::TableSetColumnIndex(0);
+                if (ImGui::Selectable(arena.format("%d", s.roll), s.roll == selectedRoll, ImGuiSelectableFlags_SpanAllColumns))
+                {
+                    selectedRoll = s.roll == selectedRoll ? -1 : s.roll;
+                    selected = s;
+                }
+
+                ImGui::TableSetColumnIndex(1);
+                ImGui::TextUnformatted(s.name.c_str(), s.name.c_str() + s.name.size());
+                ImGui::TableSetColumnIndex(2);
+                ImGui::TextUnformatted(s.department.c_str(), s.department.c_str() + s.department.size());
+                ImGui::TableSetColumnIndex(3);
+                ImGui::TextUnformatted(s.grade.c_str(), s.grade.c_str() + s.grade.size());
+                ImGui::TableSetColumnIndex(4);
+                ImGui::TextUnformatted(arena.format("%.2f", s.cgpa));
+
+                ImGui::PopID();
+                ++submittedRows;
+            }
+        }
+        ImGui::EndTable();
+
+        if (selectedRoll >= 0)
+            ImGui::Text("Selected: %s (%d), %s, grade %s, CGPA %.2f", selected.name.c_str(), selected.roll,
+                        selected.department.c_str(), selected.grade.c_str(), selected.cgpa);
+        else
+            ImGui::TextDisabled("Click a row to select it");
+    }
+
+private:
+    string lastQuery;
+    uint64_t lastVersion = ~0ULL;
+    Student selected; // copy, so drawing it never searches the roster
+
+    // Re-run the query only when it or the roster changed
+    void refresh(StudentManager &manager)
+    {
+        if (lastQuery == search && lastVersion == manager.version)
+            return;
+        if (lastVersion != manager.version && selectedRoll >= 0)
+        {
+            Student *s = manager.findByRoll(selectedRoll);
+            if (s)
+                selected = *s;
+            else
+                selectedRoll = -1;
+        }
+        visible = manager.query(search, &plan);
+        lastQuery = search;
+        lastVersion = manager.version;
+    }
+};
@@ -0,0 +1,490 @@
+// student_manager.cpp
+// StudentManager queries, sorting and file I/O
+#include "student_manager.h"
+#include <fstream>
+#include <chrono>
+#include <cstdlib>
+#include <numeric>
+#include <string_view>
+
+vector<Student *> StudentManager::search(const string &q)
+{
+    TRACE_SPAN("search");
+    vector<Student *> out;
+    string lowerq = q;
+    transform(lowerq.begin(), lowerq.end(), lowerq.begin(), ::tolower);
+    for (auto &s : students)
+        if (matchesSearch(s, lowerq))
+            out.push_back(&s);
+    return out;
+}
+
+vector<Student *> StudentManager::filter(const vector<string> &departments, const vector<string> &grades, const string &q)
+{
+    TRACE_SPAN("filter");
+    vector<Student *> out;
+    string lowerq = q;
+    transform(lowerq.begin(), lowerq.end(), lowerq.begin(), ::tolower);
+
+    auto emit = [&](uint32_t row)
+    {
+        Student &s = students[row];
+        if (lowerq.empty() || matchesSearch(s, lowerq))
+            out.push_back(&s);
+    };
+
+    if (departments.empty() && grades.empty())
+    {
+        for (uint32_t row = 0; row < students.size(); ++row)
+            emit(row);
+    }
+    else if (grades.empty())
+        departmentIndex.anyOf(departments).forEach(emit);
+    else if (departments.empty())
+        gradeIndex.anyOf(grades).forEach(emit);
+    else
+        (departmentIndex.anyOf(departments) & gradeIndex.anyOf(grades)).forEach(emit);
+    return out;
+}
+
+vector<Student *> StudentManager::query(const string &text, QueryPlan *plan)
+{
+    TRACE_SPAN("query");
+    using clock = chrono::steady_clock;
+    QueryPlan local;
+    QueryPlan &p = plan ? *plan : local;
+    p = QueryPlan();
+
+    auto t0 = clock::now();
+    QueryParser parser;
+    unique_ptr<QueryNode> root = parser.parse(text);
+    auto t1 = clock::now();
+    p.parseMs = chrono::duration<double, milli>(t1 - t0).count();
+
+    vector<Student *> out;
+    if (!parser.error.empty())
+    {
+        p.error = parser.error;
+        return out;
+    }
+    if (!root)
+    {
+        p.plan = "all rows";
+        out.reserve(students.size());
+        for (auto &s : students)
+            out.push_back(&s);
+        p.candidates = p.matches = out.size();
+        return out;
+    }
+
+    // Plan: index-backed terms of a top-level AND (or an index-only query)
+    // drive the scan; everything else is a residual batch filter
+    vector<const QueryNode *> residual;
+    vector<QueryNode *> driving;
+    if (root->indexable())
+        driving.push_back(root.get());
+    else if (root->kind == QueryNode::AND)
+    {
+        for (auto &c : root->children)
+            if (c->indexable())
+                driving.push_back(c.get());
+            else
+                residual.push_back(c.get());
+    }
+    else
+        residual.push_back(root.get());
+    p.plan = describePlan(*root);
+    auto t2 = clock::now();
+    p.planMs = chrono::duration<double, milli>(t2 - t1).count();
+
+    RoaringBitmap driver;
+    for (size_t i = 0; i < driving.size(); ++i)
+        driver = i == 0 ? bitmapFor(*driving[i]) : driver & bitmapFor(*driving[i]);
+    for (auto *r : residual)
+        resolveIndexes(*const_cast<QueryNode *>(r));
+    p.candidates = driving.empty() ? students.size() : driver.cardinality();
+    auto t3 = clock::now();
+    p.indexMs = chrono::duration<double, milli>(t3 - t2).count();
+
+    // Stream candidates through the residual filters a batch at a time
+    vector<uint32_t> rows;
+    uint32_t batch[SCAN_BATCH];
+    size_t k = 0;
+    auto flush = [&]()
+    {
+        for (auto *r : residual)
+            if (k)
+                k = filterBatch(*r, batch, k);
+        rows.insert(rows.end(), batch, batch + k);
+        k = 0;
+    };
+    if (driving.empty())
+    {
+        uint32_t total = (uint32_t)students.size();
+        for (uint32_t start = 0; start < total; start += SCAN_BATCH)
+        {
+            uint32_t n = min<uint32_t>(SCAN_BATCH, total - start);
+            for (uint32_t i = 0; i < n; ++i)
+                batch[i] = start + i;
+            k = n;
+            flush();
+        }
+    }
+    else
+        driver.forEach([&](uint32_t row)
+                       {
+                           batch[k++] = row;
+                           if (k == SCAN_BATCH)
+                               flush(); });
+    flush();
+    p.scanMs = chrono::duration<double, milli>(clock::now() - t3).count();
+
+    out.reserve(rows.size());
+    for (uint32_t row : rows)
+        out.push_back(&students[row]);
+    p.matches = out.size();
+    return out;
+}
+
+void StudentManager::sortBy(SortColumn column)
+{
+    // Same column - toggle direction; new column - default to ascending
+    sortBy(column, sortState.column == column ? !sortState.ascending : true);
+}
+
+// Row order for a string column, ties in row order. Each distinct value is
+// ranked once (departments, grades and common names repeat a lot), then rows
+// are placed by a counting sort over the ranks.
+static vector<uint32_t> orderByString(const vector<Student> &students, string Student::*field, bool ascending)
+{
+    size_t n = students.size();
+    unordered_map<string_view, uint32_t> ids;
+    vector<string_view> distinct;
+    vector<uint32_t> id(n);
+    for (size_t row = 0; row < n; ++row)
+    {
+        string_view value = students[row].*field;
+        auto it = ids.try_emplace(value, (uint32_t)distinct.size()).first;
+        if (it->second == distinct.size())
+            distinct.push_back(value);
+        id[row] = it->second;
+    }
+
+    vector<uint32_t> byValue(distinct.size());
+    iota(byValue.begin(), byValue.end(), 0);
+    sort(byValue.begin(), byValue.end(), [&](uint32_t a, uint32_t b)
+         { return ascending ? distinct[a] < distinct[b] : distinct[a] > distinct[b]; });
+    vector<uint32_t> rank(distinct.size());
+    for (uint32_t r = 0; r < byValue.size(); ++r)
+        rank[byValue[r]] = r;
+
+    vector<size_t> start(distinct.size() + 1, 0);
+    for (uint32_t v : id)
+        ++start[rank[v] + 1];
+    for (size_t r = 1; r < start.size(); ++r)
+        start[r] += start[r - 1];
+    vector<uint32_t> order(n);
+    for (size_t row = 0; row < n; ++row)
+        order[start[rank[id[row]]]++] = (uint32_t)row;
+    return order;
+}
+
+// Row order for a numeric column mirror, ties in row order
+template <typename T>
+static vector<uint32_t> orderByNumber(const vector<T> &column, bool ascending)
+{
+    vector<pair<T, uint32_t>> keyed(column.size());
+    for (size_t row = 0; row < column.size(); ++row)
+        keyed[row] = {column[row], (uint32_t)row};
+    sort(keyed.begin(), keyed.end(), [ascending](const pair<T, uint32_t> &a, const pair<T, uint32_t> &b)
+         {
+             if (a.first != b.first)
+                 return ascending ? a.first < b.first : a.first > b.first;
+             return a.second < b.second; });
+    vector<uint32_t> order(keyed.size());
+    for (size_t i = 0; i < keyed.size(); ++i)
+        order[i] = keyed[i].second;
+    return order;
+}
+
+// Keys are worked out on the columns and row numbers; each record is then
+// moved once, straight to its final place
+void StudentManager::sortBy(SortColumn column, bool ascending)
+{
+    TRACE_SPAN("sortBy");
+    sortState.column = column;
+    sortState.ascending = ascending;
+
+    vector<uint32_t> order;
+    switch (column)
+    {
+    case SortColumn::ROLL:
+        order = orderByNumber(rollColumn, ascending);
+        break;
+    case SortColumn::NAME:
+        order = orderByString(students, &Student::name, ascending);
+        break;
+    case SortColumn::GRADE:
+        order = orderByString(students, &Student::grade, ascending);
+        break;
+    case SortColumn::DEPARTMENT:
+        order = orderByString(students, &Student::department, ascending);
+        break;
+    case SortColumn::CGPA:
+        order = orderByNumber(cgpaColumn, ascending);
+        break;
+    default:
+        break;
+    }
+    if (!order.empty())
+    {
+        vector<Student> sorted;
+        sorted.reserve(students.size());
+        for (uint32_t row : order)
+            sorted.push_back(move(students[row]));
+        students.swap(sorted);
+    }
+    // A reorder leaves the aggregates as they were
+    reindexPositions();
+    ++version;
+}
+
+vector<pair<string, vector<Leaderboard::Entry>>> StudentManager::leaderboards()
+{
+    vector<pair<string, vector<Leaderboard::Entry>>> out;
+    for (auto &b : leaderboard.boards)
+    {
+        vector<Leaderboard::Entry> top = leaderboard.top(b.first, departmentIndex, students);
+        if (!top.empty())
+            out.push_back({b.first, move(top)});
+    }
+    return out;
+}
+
+void StudentManager::exportLeaderboards(const string &fname)
+{
+    TRACE_SPAN("exportLeaderboards");
+    ofstream f(fname);
+    for (auto &board : leaderboards())
+    {
+        int rank = 1;
+        for (auto &e : board.second)
+            f << board.first << '\t' << rank++ << '\t' << e.name << '\t' << e.roll << '\t' << e.cgpa << '\n';
+    }
+}
+
+void StudentManager::save(const string &fname)
+{
+    TRACE_SPAN("save");
+    ofstream f(fname);
+    for (auto &s : students)
+        writeStudentLine(f, s);
+}
+
+void StudentManager::load(const string &fname)
+{
+    TRACE_SPAN("load");
+    students.clear();
+    ifstream f(fname);
+    string line;
+    Student s;
+    while (getline(f, line))
+        if (parseStudentLine(line, s))
+            students.push_back(s);
+    rebuildIndexes();
+    changes.reset();
+    ++version;
+}
+
+// ------------------------- Roster file format -------------------------
+bool parseStudentLine(const string &line, Student &out)
+{
+    size_t end = line.size();
+    if (end && line[end - 1] == '\r')
+        --end;
+    size_t tabs[4];
+    size_t from = 0;
+    for (size_t &t : tabs)
+    {
+        t = line.find('\t', from);
+        if (t >= end)
+            return false;
+        from = t + 1;
+    }
+
+    const char *p = line.c_str();
+    char *stop;
+    long roll = strtol(p + tabs[0] + 1, &stop, 10);
+    if (stop == p + tabs[0] + 1)
+        return false;
+    float cgpa = strtof(p + tabs[3] + 1, &stop);
+    if (stop == p + tabs[3] + 1 || !isfinite(cgpa))
+        return false;
+
+    out.name.assign(line, 0, tabs[0]);
+    out.roll = (int)roll;
+    out.grade.assign(line, tabs[1] + 1, tabs[2] - tabs[1] - 1);
+    out.department.assign(line, tabs[2] + 1, tabs[3] - tabs[2] - 1);
+    out.cgpa = cgpa;
+    return true;
+}
+
+void writeStudentLine(ostream &out, const Student &s)
+{
+    out << s.name << '\t' << s.roll << '\t' << s.grade << '\t' << s.department << '\t' << s.cgpa << '\n';
+}
+
+void cleanStudentFields(Student &s)
+{
+    for (string *field : {&s.name, &s.grade, &s.department})
+        for (char &c : *field)
+            if (c == '\t' || c == '\r' || c == '\n')
+                c = ' ';
+    if (!isfinite(s.cgpa))
+        s.cgpa = 0.0f;
+}
+
+string StudentManager::describePlan(const QueryNode &n) const
+{
+    bool grouped = n.kind == QueryNode::AND || n.kind == QueryNode::OR;
+    if (n.indexable())
+        return grouped ? "index" + n.describe() : "index(" + n.describe() + ")";
+    if (n.kind != QueryNode::AND)
+        return grouped ? "scan" + n.describe() : "scan(" + n.describe() + ")";
+    string indexed, scanned;
+    for (auto &c : n.children)
+    {
+        string &dst = c->indexable() ? indexed : scanned;
+        dst += (dst.empty() ? "" : " & ") + c->describe();
+    }
+    return indexed.empty() ? "scan(" + scanned + ")" : "index(" + indexed + ") -> scan(" + scanned + ")";
+}
+
+RoaringBitmap StudentManager::bitmapFor(const QueryNode &n) const
+{
+    if (n.kind == QueryNode::DEPT || n.kind == QueryNode::GRADE)
+    {
+        const FieldIndex &index = n.kind == QueryNode::DEPT ? departmentIndex : gradeIndex;
+        if (n.prefix)
+            return index.withPrefix(n.value);
+        const RoaringBitmap *b = index.find(n.value);
+        return b ? *b : RoaringBitmap();
+    }
+    RoaringBitmap out = bitmapFor(*n.children[0]);
+    for (size_t i = 1; i < n.children.size(); ++i)
+        out = n.kind == QueryNode::AND ? out & bitmapFor(*n.children[i]) : out | bitmapFor(*n.children[i]);
+    return out;
+}
+
+void StudentManager::resolveIndexes(QueryNode &n) const
+{
+    if (n.indexable())
+    {
+        n.matches = bitmapFor(n);
+        return;
+    }
+    for (auto &c : n.children)
+        resolveIndexes(*c);
+}
+
+size_t StudentManager::filterBatch(const QueryNode &n, uint32_t *rows, size_t k) const
+{
+    if (n.indexable())
+        return compact(rows, k, [&n](uint32_t r)
+                       { return n.matches.contains(r); });
+
+    uint32_t tmp[SCAN_BATCH];
+    switch (n.kind)
+    {
+    case QueryNode::AND:
+        for (auto &c : n.children)
+            if (k)
+                k = filterBatch(*c, rows, k);
+        return k;
+    case QueryNode::OR:
+    {
+        bool hit[SCAN_BATCH] = {};
+        for (auto &c : n.children)
+        {
+            copy(rows, rows + k, tmp);
+            size_t m = filterBatch(*c, tmp, k);
+            for (size_t i = 0, j = 0; j < m; ++i)
+                if (rows[i] == tmp[j])
+                {
+                    hit[i] = true;
+                    ++j;
+                }
+        }
+        size_t i = 0;
+        return compact(rows, k, [&](uint32_t)
+                       { return hit[i++]; });
+    }
+    case QueryNode::NOT:
+    {
+        copy(rows, rows + k, tmp);
+        size_t m = filterBatch(*n.children[0], tmp, k), j = 0;
+        return compact(rows, k, [&](uint32_t r)
+                       {
+                           if (j < m && tmp[j] == r)
+                           {
+                               ++j;
+                               return false;
+                           }
+                           return true; });
+    }
+    case QueryNode::CGPA:
+    {
+        // Stored CGPAs are shown to two decimals, so '=' matches that precision
+        float v = (float)n.number;
+        bool eq = n.op == QueryNode::EQ;
+        return compare(cgpaColumn.data(), n.op, eq ? v - 0.005f : v, eq ? v + 0.005f : v, rows, k);
+    }
+    case QueryNode::ROLL:
+        return compare(rollColumn.data(), n.op, (int)n.number, (int)n.number, rows, k);
+    case QueryNode::NAME:
+        return compact(rows, k, [&](uint32_t r)
+                       { return containsLower(students[r].name, n.value); });
+    default:
+        return compact(rows, k, [&](uint32_t r)
+                       { return matchesSearch(students[r], n.value); });
+    }
+}
+
+// The bitmaps are rebuilt whole; the columns and roll index only from `from`
+void StudentManager::reindexPositions(uint32_t from)
+{
+    departmentIndex.clear();
+    gradeIndex.clear();
+    for (uint32_t row = 0; row < students.size(); ++row)
+    {
+        departmentIndex.insert(students[row].department, row);
+        gradeIndex.insert(students[row].grade, row);
+    }
+    cgpaColumn.resize(students.size());
+    rollColumn.resize(students.size());
+    for (uint32_t row = from; row < students.size(); ++row)
+    {
+        const Student &s = students[row];
+        cgpaColumn[row] = s.cgpa;
+        rollColumn[row] = s.roll;
+        rollIndex[s.roll] = row;
+    }
+}
+
+void StudentManager::rebuildIndexes()
+{
+    // The first row with a roll keeps it; its position is filled in below
+    rollIndex.clear();
+    rollIndex.reserve(students.size());
+    students.erase(remove_if(students.begin(), students.end(),
+                             [&](const Student &s)
+                             { return !rollIndex.emplace(s.roll, 0).second; }),
+                   students.end());
+    reindexPositions();
+    aggregates.rebuild(departmentIndex, gradeIndex, cgpaColumn);
+    ranks.rebuild(aggregates);
+    // Every board is read again from its bitmap on its next query
+    leaderboard.clear();
+    for (auto &d : departmentIndex.values)
+        leaderboard.boards[d.first].dirty = true;
+}
@@ -0,0 +1,1390 @@
+// student_manager.h
+// Student records, indexes and queries, shared by the GUI and headless tools
+#pragma once
+#include <vector>
+#include <string>
+#include <sstream>
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <cstdint>
+#include <memory>
+#include <deque>
+#include <unordered_map>
+#include <charconv>
+#include <cmath>
+#include "trace.h"
+using namespace std;
+
+// ------------------------- Student Structures -------------------------
+class Student
+{
+public:
+    string name;
+    int roll;
+    string grade;
+    string department;
+    float cgpa;
+};
+
+// Roster files hold one student per line: name \t roll \t grade \t department \t cgpa.
+// parseStudentLine rejects lines that don't have all five fields or whose
+// CGPA is not a finite number.
+bool parseStudentLine(const string &line, Student &out);
+void writeStudentLine(ostream &out, const Student &s);
+// Turns tabs, CRs and newlines in the text fields into spaces so a record
+// from outside (an import, a client) can't split or shift a roster line,
+// and a non-finite CGPA into 0 as the GUI does with one it can't parse.
+void cleanStudentFields(Student &s);
+
+// Sorting state
+enum class SortColumn
+{
+    NONE,
+    ROLL,
+    NAME,
+    GRADE,
+    DEPARTMENT,
+    CGPA
+};
+class SortState
+{
+public:
+    SortColumn column = SortColumn::NONE;
+    bool ascending = true;
+};
+
+// ------------------------- Bitmap Indexes -------------------------
+// Roaring-style compressed bitmap over row positions. Row ids are split into
+// 2^16 blocks; each block is a sorted array while sparse and switches to a
+// 65536-bit bitmap once it holds more than 4096 rows.
+class RoaringBitmap
+{
+public:
+    static constexpr uint32_t ARRAY_LIMIT = 4096;
+    static constexpr uint32_t BITMAP_WORDS = 1024;
+
+    class Container
+    {
+    public:
+        uint16_t key = 0;
+        uint32_t cardinality = 0;
+        vector<uint16_t> array; // sorted, used while cardinality <= ARRAY_LIMIT
+        vector<uint64_t> bits;  // BITMAP_WORDS words once dense
+
+        bool isBitmap() const { return !bits.empty(); }
+
+        bool contains(uint16_t low) const
+        {
+            if (isBitmap())
+                return (bits[low >> 6] >> (low & 63)) & 1;
+            return binary_search(array.begin(), array.end(), low);
+        }
+
+        bool add(uint16_t low)
+        {
+            if (isBitmap())
+            {
+                uint64_t mask = 1ULL << (low & 63);
+                if (bits[low >> 6] & mask)
+                    return false;
+                bits[low >> 6] |= mask;
+                ++cardinality;
+                return true;
+            }
+            // Rows are mostly appended in order, so try the back first
+            if (array.empty() || array.back() < low)
+                array.push_back(low);
+            else
+            {
+                auto it = lower_bound(array.begin(), array.end(), low);
+                if (*it == low)
+                    return false;
+                array.insert(it, low);
+            }
+            ++cardinality;
+            if (cardinality > ARRAY_LIMIT)
+                toBitmap();
+            return true;
+        }
+
+        bool remove(uint16_t low)
+        {
+            if (isBitmap())
+            {
+                uint64_t mask = 1ULL << (low & 63);
+                if (!(bits[low >> 6] & mask))
+                    return false;
+                bits[low >> 6] &= ~mask;
+                --cardinality;
+                if (cardinality <= ARRAY_LIMIT)
+                    toArray();
+                return true;
+            }
+            auto it = lower_bound(array.begin(), array.end(), low);
+            if (it == array.end() || *it != low)
+                return false;
+            array.erase(it);
+            --cardinality;
+            return true;
+        }
+
+        void toBitmap()
+        {
+            bits.assign(BITMAP_WORDS, 0);
+            for (uint16_t v : array)
+                bits[v >> 6] |= 1ULL << (v & 63);
+            array.clear();
+            array.shrink_to_fit();
+        }
+
+        void toArray()
+        {
+            array.clear();
+            array.reserve(cardinality);
+            for (uint32_t w = 0; w < BITMAP_WORDS; ++w)
+            {
+                uint64_t word = bits[w];
+                while (word)
+                {
+                    array.push_back((uint16_t)(w * 64 + __builtin_ctzll(word)));
+                    word &= word - 1;
+                }
+            }
+            bits.clear();
+            bits.shrink_to_fit();
+        }
+
+        template <typename F>
+        void forEach(F f) const
+        {
+            uint32_t base = (uint32_t)key << 16;
+            if (!isBitmap())
+            {
+                for (uint16_t v : array)
+                    f(base | v);
+                return;
+            }
+            for (uint32_t w = 0; w < BITMAP_WORDS; ++w)
+            {
+                uint64_t word = bits[w];
+                while (word)
+                {
+                    f(base | (w * 64 + __builtin_ctzll(word)));
+                    word &= word - 1;
+                }
+            }
+        }
+    };
+
+    vector<Container> containers; // sorted by key
+    uint64_t count = 0;
+
+    uint64_t cardinality() const { return count; }
+    bool empty() const { return count == 0; }
+
+    void clear()
+    {
+        containers.clear();
+        count = 0;
+    }
+
+    void add(uint32_t v)
+    {
+        Container &c = containerFor((uint16_t)(v >> 16));
+        if (c.add((uint16_t)(v & 0xFFFF)))
+            ++count;
+    }
+
+    void remove(uint32_t v)
+    {
+        auto it = findContainer((uint16_t)(v >> 16));
+        if (it == containers.end() || !it->remove((uint16_t)(v & 0xFFFF)))
+            return;
+        --count;
+        if (it->cardinality == 0)
+            containers.erase(it);
+    }
+
+    bool contains(uint32_t v) const
+    {
+        auto it = lower_bound(containers.begin(), containers.end(), (uint16_t)(v >> 16),
+                              [](const Container &c, uint16_t k)
+                              { return c.key < k; });
+        return it != containers.end() && it->key == (uint16_t)(v >> 16) && it->contains((uint16_t)(v & 0xFFFF));
+    }
+
+    template <typename F>
+    void forEach(F f) const
+    {
+        for (auto &c : containers)
+            c.forEach(f);
+    }
+
+    // Conjunction: only blocks present in both sides can produce rows
+    RoaringBitmap operator&(const RoaringBitmap &o) const
+    {
+        RoaringBitmap out;
+        size_t i = 0, j = 0;
+        while (i < containers.size() && j < o.containers.size())
+        {
+            const Container &a = containers[i], &b = o.containers[j];
+            if (a.key < b.key)
+                ++i;
+            else if (b.key < a.key)
+                ++j;
+            else
+            {
+                Container c = intersect(a, b);
+                if (c.cardinality)
+                {
+                    out.count += c.cardinality;
+                    out.containers.push_back(move(c));
+                }
+                ++i;
+                ++j;
+            }
+        }
+        return out;
+    }
+
+    // Disjunction: merge blocks, unioning the ones both sides share
+    RoaringBitmap operator|(const RoaringBitmap &o) const
+    {
+        RoaringBitmap out;
+        size_t i = 0, j = 0;
+        while (i < containers.size() || j < o.containers.size())
+        {
+            if (j == o.containers.size() || (i < containers.size() && containers[i].key < o.containers[j].key))
+                out.containers.push_back(containers[i++]);
+            else if (i == containers.size() || o.containers[j].key < containers[i].key)
+                out.containers.push_back(o.containers[j++]);
+            else
+                out.containers.push_back(unite(containers[i++], o.containers[j++]));
+            out.count += out.containers.back().cardinality;
+        }
+        return out;
+    }
+
+    RoaringBitmap &operator|=(const RoaringBitmap &o)
+    {
+        if (empty())
+            return *this = o;
+        return *this = *this | o;
+    }
+
+private:
+    vector<Container>::iterator findContainer(uint16_t key)
+    {
+        auto it = lower_bound(containers.begin(), containers.end(), key,
+                              [](const Container &c, uint16_t k)
+                              { return c.key < k; });
+        if (it != containers.end() && it->key != key)
+            return containers.end();
+        return it;
+    }
+
+    Container &containerFor(uint16_t key)
+    {
+        if (!containers.empty() && containers.back().key == key)
+            return containers.back();
+        auto it = lower_bound(containers.begin(), containers.end(), key,
+                              [](const Container &c, uint16_t k)
+                              { return c.key < k; });
+        if (it == containers.end() || it->key != key)
+        {
+            Container c;
+            c.key = key;
+            it = containers.insert(it, move(c));
+        }
+        return *it;
+    }
+
+    static Container intersect(const Container &a, const Container &b)
+    {
+        Container out;
+        out.key = a.key;
+        if (a.isBitmap() && b.isBitmap())
+        {
+            // Count first so sparse results go straight to an array
+            for (uint32_t w = 0; w < BITMAP_WORDS; ++w)
+                out.cardinality += __builtin_popcountll(a.bits[w] & b.bits[w]);
+            if (out.cardinality > ARRAY_LIMIT)
+            {
+                out.bits.resize(BITMAP_WORDS);
+                for (uint32_t w = 0; w < BITMAP_WORDS; ++w)
+                    out.bits[w] = a.bits[w] & b.bits[w];
+                return out;
+            }
+            out.array.reserve(out.cardinality);
+            for (uint32_t w = 0; w < BITMAP_WORDS; ++w)
+            {
+                uint64_t word = a.bits[w] & b.bits[w];
+                while (word)
+                {
+                    out.array.push_back((uint16_t)(w * 64 + __builtin_ctzll(word)));
+                    word &= word - 1;
+                }
+            }
+        }
+        else if (a.isBitmap() || b.isBitmap())
+        {
+            const Container &arr = a.isBitmap() ? b : a;
+            const Container &bmp = a.isBitmap() ? a : b;
+            for (uint16_t v : arr.array)
+                if (bmp.contains(v))
+                    out.array.push_back(v);
+            out.cardinality = out.array.size();
+        }
+        else
+        {
+            set_intersection(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                             back_inserter(out.array));
+            out.cardinality = out.array.size();
+        }
+        return out;
+    }
+
+    static Container unite(const Container &a, const Container &b)
+    {
+        Container out;
+        out.key = a.key;
+        if (!a.isBitmap() && !b.isBitmap() && a.cardinality + b.cardinality <= ARRAY_LIMIT)
+        {
+            set_union(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                      back_inserter(out.array));
+            out.cardinality = out.array.size();
+            return out;
+        }
+        out.bits.assign(BITMAP_WORDS, 0);
+        for (const Container *c : {&a, &b})
+        {
+            if (c->isBitmap())
+                for (uint32_t w = 0; w < BITMAP_WORDS; ++w)
+                    out.bits[w] |= c->bits[w];
+            else
+                for (uint16_t v : c->array)
+                    out.bits[v >> 6] |= 1ULL << (v & 63);
+        }
+        for (uint32_t w = 0; w < BITMAP_WORDS; ++w)
+            out.cardinality += __builtin_popcountll(out.bits[w]);
+        if (out.cardinality <= ARRAY_LIMIT)
+            out.toArray();
+        return out;
+    }
+};
+
+// One bitmap of row positions per distinct value of a string column
+class FieldIndex
+{
+public:
+    map<string, RoaringBitmap> values;
+
+    void clear() { values.clear(); }
+
+    void insert(const string &value, uint32_t row) { values[value].add(row); }
+
+    void erase(const string &value, uint32_t row)
+    {
+        auto it = values.find(value);
+        if (it == values.end())
+            return;
+        it->second.remove(row);
+        if (it->second.empty())
+            values.erase(it);
+    }
+
+    const RoaringBitmap *find(const string &value) const
+    {
+        auto it = values.find(value);
+        return it == values.end() ? nullptr : &it->second;
+    }
+
+    // Facet count for a single value
+    uint64_t count(const string &value) const
+    {
+        const RoaringBitmap *b = find(value);
+        return b ? b->cardinality() : 0;
+    }
+
+    // Union of every value in the list (disjunctive filter)
+    RoaringBitmap anyOf(const vector<string> &wanted) const
+    {
+        RoaringBitmap out;
+        for (auto &v : wanted)
+            if (const RoaringBitmap *b = find(v))
+                out |= *b;
+        return out;
+    }
+
+    // Union of every value starting with prefix, e.g. "A" matches A, A+, A-
+    RoaringBitmap withPrefix(const string &prefix) const
+    {
+        RoaringBitmap out;
+        for (auto it = values.lower_bound(prefix); it != values.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it)
+            out |= it->second;
+        return out;
+    }
+};
+
+// ------------------------- Query Language -------------------------
+// Search box syntax, e.g.  dept:CSE cgpa>=3.5 grade:A* name~rahman
+//   dept:X grade:X   exact match through the bitmap indexes, X* for a prefix
+//   name~text        case-insensitive substring (name:text works too)
+//   cgpa>=3.5        compare cgpa or roll with = < <= > >=
+//   a | b, -a, (..)  OR, NOT and grouping; neighbouring terms are ANDed
+//   anything else    matches name or roll like the plain search
+class QueryNode
+{
+public:
+    enum Kind
+    {
+        AND,
+        OR,
+        NOT,
+        DEPT,
+        GRADE,
+        NAME,
+        TEXT,
+        CGPA,
+        ROLL
+    };
+    enum Op
+    {
+        EQ,
+        LT,
+        LE,
+        GT,
+        GE
+    };
+
+    Kind kind = TEXT;
+    Op op = EQ;
+    string value;        // lowercased for NAME and TEXT
+    bool prefix = false; // DEPT/GRADE value ended in '*'
+    double number = 0;
+    vector<unique_ptr<QueryNode>> children;
+    RoaringBitmap matches; // filled by the planner for index-backed subtrees
+
+    // Department and grade terms (and AND/OR trees of them) resolve to bitmaps
+    bool indexable() const
+    {
+        if (kind == DEPT || kind == GRADE)
+            return true;
+        if (kind != AND && kind != OR)
+            return false;
+        for (auto &c : children)
+            if (!c->indexable())
+                return false;
+        return true;
+    }
+
+    string describe() const
+    {
+        static const char *ops[] = {"=", "<", "<=", ">", ">="};
+        switch (kind)
+        {
+        case DEPT:
+            return "dept=" + value + (prefix ? "*" : "");
+        case GRADE:
+            return "grade=" + value + (prefix ? "*" : "");
+        case NAME:
+            return "name~" + value;
+        case TEXT:
+            return "text~" + value;
+        case CGPA:
+        case ROLL:
+        {
+            ostringstream ss;
+            ss << (kind == CGPA ? "cgpa" : "roll") << ops[op] << number;
+            return ss.str();
+        }
+        case NOT:
+            return "-" + children[0]->describe();
+        default:
+        {
+            string out = "(";
+            for (size_t i = 0; i < children.size(); ++i)
+            {
+                if (i)
+                    out += kind == AND ? " & " : " | ";
+                out += children[i]->describe();
+            }
+            return out + ")";
+        }
+        }
+    }
+};
+
+class QueryParser
+{
+public:
+    string error;
+
+    // Returns nullptr for an empty query or when `error` is set
+    unique_ptr<QueryNode> parse(const string &text)
+    {
+        tokens.clear();
+        pos = 0;
+        error.clear();
+        tokenize(text);
+        if (tokens.empty())
+            return nullptr;
+        unique_ptr<QueryNode> root = parseOr();
+        if (!error.empty())
+            return nullptr;
+        if (pos < tokens.size())
+        {
+            error = "unexpected '" + tokens[pos] + "'";
+            return nullptr;
+        }
+        return root;
+    }
+
+private:
+    vector<string> tokens;
+    size_t pos = 0;
+
+    void tokenize(const string &text)
+    {
+        string cur;
+        for (char c : text)
+        {
+            if (isspace((unsigned char)c) || c == '(' || c == ')' || c == '|')
+            {
+                if (!cur.empty())
+                    tokens.push_back(cur);
+                cur.clear();
+                if (!isspace((unsigned char)c))
+                    tokens.push_back(string(1, c));
+            }
+            else
+                cur.push_back(c);
+        }
+        if (!cur.empty())
+            tokens.push_back(cur);
+    }
+
+    static bool isOr(const string &t) { return t == "|" || t == "OR"; }
+
+    static unique_ptr<QueryNode> combine(QueryNode::Kind kind, vector<unique_ptr<QueryNode>> &parts)
+    {
+        if (parts.size() == 1)
+            return move(parts[0]);
+        auto n = make_unique<QueryNode>();
+        n->kind = kind;
+        n->children = move(parts);
+        return n;
+    }
+
+    unique_ptr<QueryNode> parseOr()
+    {
+        vector<unique_ptr<QueryNode>> parts;
+        parts.push_back(parseAnd());
+        while (error.empty() && pos < tokens.size() && isOr(tokens[pos]))
+        {
+            ++pos;
+            parts.push_back(parseAnd());
+        }
+        return combine(QueryNode::OR, parts);
+    }
+
+    unique_ptr<QueryNode> parseAnd()
+    {
+        vector<unique_ptr<QueryNode>> parts;
+        while (error.empty() && pos < tokens.size() && tokens[pos] != ")" && !isOr(tokens[pos]))
+            parts.push_back(parseUnary());
+        if (parts.empty())
+        {
+            if (error.empty())
+                error = "missing term";
+            return nullptr;
+        }
+        return combine(QueryNode::AND, parts);
+    }
+
+    unique_ptr<QueryNode> parseUnary()
+    {
+        string tok = tokens[pos++];
+        if (tok == "(")
+        {
+            unique_ptr<QueryNode> inner = parseOr();
+            if (error.empty() && (pos >= tokens.size() || tokens[pos] != ")"))
+                error = "missing ')'";
+            ++pos;
+            return inner;
+        }
+        if (tok.size() > 1 && tok[0] == '-')
+        {
+            auto n = make_unique<QueryNode>();
+            n->kind = QueryNode::NOT;
+            n->children.push_back(parseTerm(tok.substr(1)));
+            return n;
+        }
+        return parseTerm(tok);
+    }
+
+    unique_ptr<QueryNode> parseTerm(const string &tok)
+    {
+        auto n = make_unique<QueryNode>();
+        size_t opPos = tok.find_first_of(":~<>=");
+        string field = opPos == string::npos ? "" : tok.substr(0, opPos);
+        transform(field.begin(), field.end(), field.begin(), ::tolower);
+
+        if (field == "dept" || field == "department" || field == "grade")
+        {
+            if (tok[opPos] != ':' && tok[opPos] != '=')
+            {
+                error = field + " only supports ':'";
+                return n;
+            }
+            n->kind = field == "grade" ? QueryNode::GRADE : QueryNode::DEPT;
+            n->value = tok.substr(opPos + 1);
+            if (!n->value.empty() && n->value.back() == '*')
+            {
+                n->prefix = true;
+                n->value.pop_back();
+            }
+        }
+        else if (field == "name" && (tok[opPos] == '~' || tok[opPos] == ':'))
+        {
+            n->kind = QueryNode::NAME;
+            n->value = tok.substr(opPos + 1);
+        }
+        else if (field == "cgpa" || field == "roll")
+        {
+            n->kind = field == "cgpa" ? QueryNode::CGPA : QueryNode::ROLL;
+            size_t numPos = opPos + 1;
+            if (tok[opPos] == ':' || tok[opPos] == '=')
+                n->op = QueryNode::EQ;
+            else if (tok[opPos] == '<' || tok[opPos] == '>')
+            {
+                bool orEqual = numPos < tok.size() && tok[numPos] == '=';
+                if (orEqual)
+                    ++numPos;
+                n->op = tok[opPos] == '<' ? (orEqual ? QueryNode::LE : QueryNode::LT)
+                                          : (orEqual ? QueryNode::GE : QueryNode::GT);
+            }
+            else
+            {
+                error = field + " needs a comparison";
+                return n;
+            }
+            try
+            {
+                size_t used = 0;
+                n->number = stod(tok.substr(numPos), &used);
+                if (used != tok.size() - numPos)
+                    throw invalid_argument("trailing");
+            }
+            catch (...)
+            {
+                error = "bad number in '" + tok + "'";
+                return n;
+            }
+            // The roll column is compared as ints, so a fraction would be cut off
+            if (n->kind == QueryNode::ROLL &&
+                (trunc(n->number) != n->number || fabs(n->number) > INT32_MAX))
+                error = "roll needs a whole number in '" + tok + "'";
+        }
+        else
+        {
+            n->kind = QueryNode::TEXT;
+            n->value = tok;
+        }
+        if (n->kind == QueryNode::NAME || n->kind == QueryNode::TEXT)
+            transform(n->value.begin(), n->value.end(), n->value.begin(), ::tolower);
+        return n;
+    }
+};
+
+// What the planner chose and where the time went, shown under the search box
+class QueryPlan
+{
+public:
+    string plan;
+    string error;
+    double parseMs = 0, planMs = 0, indexMs = 0, scanMs = 0;
+    size_t candidates = 0, matches = 0;
+
+    double totalMs() const { return parseMs + planMs + indexMs + scanMs; }
+};
+
+// ------------------------- Aggregates -------------------------
+// CGPA is tracked in 0.01 buckets (0.00 .. 4.00), the precision the UI shows,
+// so min/max survive deletions without rescanning the roster.
+static const int CGPA_BUCKETS = 401;
+static const int HISTOGRAM_BINS = 8; // 0.5-wide bins for the stats panel
+
+inline int cgpaBucket(float cgpa)
+{
+    int b = (int)lround(cgpa * 100.0f);
+    return b < 0 ? 0 : (b >= CGPA_BUCKETS ? CGPA_BUCKETS - 1 : b);
+}
+
+class GroupStats
+{
+public:
+    uint64_t count = 0;
+    double sum = 0;
+    int minBucket = CGPA_BUCKETS, maxBucket = -1;
+    uint32_t histogram[HISTOGRAM_BINS] = {};
+    vector<uint32_t> buckets = vector<uint32_t>(CGPA_BUCKETS, 0);
+
+    void insert(float cgpa)
+    {
+        int b = cgpaBucket(cgpa);
+        ++count;
+        sum += cgpa;
+        ++buckets[b];
+        ++histogram[histogramBin(b)];
+        minBucket = min(minBucket, b);
+        maxBucket = max(maxBucket, b);
+    }
+
+    void erase(float cgpa)
+    {
+        int b = cgpaBucket(cgpa);
+        if (buckets[b] == 0)
+            return;
+        --count;
+        sum -= cgpa;
+        --buckets[b];
+        --histogram[histogramBin(b)];
+        if (count == 0)
+        {
+            sum = 0;
+            minBucket = CGPA_BUCKETS;
+            maxBucket = -1;
+            return;
+        }
+        // Walk at most CGPA_BUCKETS steps to the next occupied bucket
+        while (buckets[minBucket] == 0)
+            ++minBucket;
+        while (buckets[maxBucket] == 0)
+            --maxBucket;
+    }
+
+    double mean() const { return count ? sum / count : 0.0; }
+    float minCgpa() const { return count ? minBucket / 100.0f : 0.0f; }
+    float maxCgpa() const { return count ? maxBucket / 100.0f : 0.0f; }
+
+private:
+    static int histogramBin(int bucket) { return min(HISTOGRAM_BINS - 1, bucket / 50); }
+};
+
+// Headcount and CGPA statistics per department and per grade, kept current
+// by StudentManager on every mutation
+class RosterAggregates
+{
+public:
+    GroupStats overall;
+    map<string, GroupStats> byDepartment;
+    map<string, GroupStats> byGrade;
+
+    void clear()
+    {
+        overall = GroupStats();
+        byDepartment.clear();
+        byGrade.clear();
+    }
+
+    void insert(const Student &s)
+    {
+        overall.insert(s.cgpa);
+        byDepartment[s.department].insert(s.cgpa);
+        byGrade[s.grade].insert(s.cgpa);
+    }
+
+    void erase(const Student &s)
+    {
+        overall.erase(s.cgpa);
+        eraseFrom(byDepartment, s.department, s.cgpa);
+        eraseFrom(byGrade, s.grade, s.cgpa);
+    }
+
+    // Full recompute from the bitmap indexes: one group lookup per value
+    // instead of per row, reading CGPAs from the column
+    void rebuild(const FieldIndex &departments, const FieldIndex &grades, const vector<float> &cgpa)
+    {
+        clear();
+        for (float c : cgpa)
+            overall.insert(c);
+        for (auto &v : departments.values)
+        {
+            GroupStats &g = byDepartment[v.first];
+            v.second.forEach([&](uint32_t row)
+                             { g.insert(cgpa[row]); });
+        }
+        for (auto &v : grades.values)
+        {
+            GroupStats &g = byGrade[v.first];
+            v.second.forEach([&](uint32_t row)
+                             { g.insert(cgpa[row]); });
+        }
+    }
+
+private:
+    static void eraseFrom(map<string, GroupStats> &groups, const string &key, float cgpa)
+    {
+        auto it = groups.find(key);
+        if (it == groups.end())
+            return;
+        it->second.erase(cgpa);
+        if (it->second.count == 0)
+            groups.erase(it);
+    }
+};
+
+// ------------------------- Rank Index -------------------------
+// Fenwick tree over the CGPA buckets: prefix counts, ranks and percentiles
+// in O(log CGPA_BUCKETS)
+class CgpaFenwick
+{
+public:
+    vector<uint32_t> tree = vector<uint32_t>(CGPA_BUCKETS + 1, 0);
+    uint64_t total = 0;
+
+    void add(float cgpa, int delta)
+    {
+        total += delta;
+        for (int i = cgpaBucket(cgpa) + 1; i <= CGPA_BUCKETS; i += i & -i)
+            tree[i] += delta;
+    }
+
+    // O(buckets) construction from per-bucket counts
+    void build(const vector<uint32_t> &buckets)
+    {
+        total = 0;
+        for (int i = 1; i <= CGPA_BUCKETS; ++i)
+        {
+            tree[i] = buckets[i - 1];
+            total += buckets[i - 1];
+        }
+        for (int i = 1; i <= CGPA_BUCKETS; ++i)
+        {
+            int parent = i + (i & -i);
+            if (parent <= CGPA_BUCKETS)
+                tree[parent] += tree[i];
+        }
+    }
+
+    // Students whose CGPA bucket is <= the given bucket
+    uint64_t countAtMost(int bucket) const
+    {
+        uint64_t sum = 0;
+        for (int i = bucket + 1; i > 0; i -= i & -i)
+            sum += tree[i];
+        return sum;
+    }
+
+    // 1-based competition rank: students with the same CGPA share a rank
+    uint64_t rankOf(float cgpa) const { return total - countAtMost(cgpaBucket(cgpa)) + 1; }
+
+    // Smallest CGPA with at least fraction p of students at or below it
+    float percentile(double p) const
+    {
+        if (total == 0)
+            return 0.0f;
+        uint64_t target = (uint64_t)ceil(p * total);
+        if (target == 0)
+            target = 1;
+        int pos = 0;
+        for (int step = 512; step > 0; step >>= 1)
+            if (pos + step <= CGPA_BUCKETS && tree[pos + step] < target)
+            {
+                pos += step;
+                target -= tree[pos];
+            }
+        return pos / 100.0f; // pos is the 0-based bucket holding the target
+    }
+};
+
+class RankIndex
+{
+public:
+    CgpaFenwick overall;
+    map<string, CgpaFenwick> byDepartment;
+
+    void insert(const Student &s)
+    {
+        overall.add(s.cgpa, 1);
+        byDepartment[s.department].add(s.cgpa, 1);
+    }
+
+    void erase(const Student &s)
+    {
+        overall.add(s.cgpa, -1);
+        auto it = byDepartment.find(s.department);
+        if (it == byDepartment.end())
+            return;
+        it->second.add(s.cgpa, -1);
+        if (it->second.total == 0)
+            byDepartment.erase(it);
+    }
+
+    void rebuild(const RosterAggregates &agg)
+    {
+        overall.build(agg.overall.buckets);
+        byDepartment.clear();
+        for (auto &d : agg.byDepartment)
+            byDepartment[d.first].build(d.second.buckets);
+    }
+
+    uint64_t departmentRank(const Student &s) const
+    {
+        auto it = byDepartment.find(s.department);
+        return it == byDepartment.end() ? 0 : it->second.rankOf(s.cgpa);
+    }
+
+    uint64_t departmentSize(const string &department) const
+    {
+        auto it = byDepartment.find(department);
+        return it == byDepartment.end() ? 0 : it->second.total;
+    }
+};
+
+// ------------------------- Leaderboard -------------------------
+// Top-N students by CGPA per department, each kept in a bounded min-heap.
+// Entries carry the student's roll and name rather than a row position, so
+// sorting or deleting other rows leaves them valid. Removing or editing a
+// member marks its department dirty; the heap is rebuilt from the department
+// bitmap the next time it is read.
+class Leaderboard
+{
+public:
+    static constexpr size_t TOP_N = 10;
+
+    class Entry
+    {
+    public:
+        float cgpa;
+        int roll;
+        string name;
+    };
+
+    class Board
+    {
+    public:
+        vector<Entry> heap; // worst entry at the front
+        bool dirty = false;
+    };
+
+    map<string, Board> boards;
+
+    // Higher CGPA wins, then the lower roll
+    static bool better(const Entry &a, const Entry &b)
+    {
+        return a.cgpa != b.cgpa ? a.cgpa > b.cgpa : a.roll < b.roll;
+    }
+
+    void clear() { boards.clear(); }
+
+    void insert(const Student &s)
+    {
+        Board &b = boards[s.department];
+        if (!b.dirty)
+            offer(b.heap, s);
+    }
+
+    void erase(const Student &s)
+    {
+        auto it = boards.find(s.department);
+        if (it == boards.end() || it->second.dirty)
+            return;
+        for (auto &e : it->second.heap)
+            if (e.roll == s.roll)
+            {
+                it->second.dirty = true;
+                return;
+            }
+    }
+
+    // Best-first entries for one department, rebuilding the heap if needed
+    vector<Entry> top(const string &department, const FieldIndex &departments, const vector<Student> &students)
+    {
+        auto it = boards.find(department);
+        if (it == boards.end())
+            return {};
+        Board &b = it->second;
+        if (b.dirty)
+        {
+            b.heap.clear();
+            if (const RoaringBitmap *rows = departments.find(department))
+                rows->forEach([&](uint32_t row)
+                              { offer(b.heap, students[row]); });
+            b.dirty = false;
+        }
+        vector<Entry> out = b.heap;
+        sort(out.begin(), out.end(), better);
+        return out;
+    }
+
+private:
+    // The name is only copied for a student who makes the board
+    static void offer(vector<Entry> &heap, const Student &s)
+    {
+        if (heap.size() < TOP_N)
+        {
+            heap.push_back({s.cgpa, s.roll, s.name});
+            push_heap(heap.begin(), heap.end(), better);
+        }
+        else if (better({s.cgpa, s.roll, {}}, heap.front()))
+        {
+            pop_heap(heap.begin(), heap.end(), better);
+            heap.back() = {s.cgpa, s.roll, s.name};
+            push_heap(heap.begin(), heap.end(), better);
+        }
+    }
+};
+
+// ------------------------- Change Feed -------------------------
+// Every row mutation gets the next sequence number. A subscriber keeps the
+// last sequence it applied and asks for everything after it; repeated changes
+// to one roll collapse to the newest. Replacing the whole roster (load,
+// assign) or falling out of the retained window means the subscriber has to
+// reload instead.
+class RowChange
+{
+public:
+    enum Kind : uint8_t
+    {
+        UPSERT, // row holds the new values
+        REMOVE  // only row.roll is set
+    };
+
+    uint64_t seq = 0;
+    Kind kind = UPSERT;
+    Student row;
+};
+
+class ChangeFeed
+{
+public:
+    static constexpr size_t CAPACITY = 1 << 16; // changes kept for catching up
+
+    uint64_t lastSeq = 0;  // newest change
+    uint64_t resetSeq = 0; // nothing at or before this can be replayed
+
+    void upsert(const Student &s) { append(RowChange::UPSERT, s); }
+
+    void removed(int roll)
+    {
+        Student s{"", roll, "", "", 0.0f};
+        append(RowChange::REMOVE, s);
+    }
+
+    void reset()
+    {
+        log.clear();
+        resetSeq = ++lastSeq;
+    }
+
+    // Append the changes after `seq` to out, oldest first, one per roll (the
+    // manager keeps rolls unique, so that is one per row). Returns false
+    // when they are no longer available.
+    bool since(uint64_t seq, vector<RowChange> &out) const
+    {
+        if (seq < resetSeq || seq > lastSeq || (!log.empty() && log.front().seq > seq + 1))
+            return false;
+        size_t first = log.size() - (size_t)(lastSeq - seq);
+        unordered_map<int, size_t> newest; // roll -> index into log
+        for (size_t i = first; i < log.size(); ++i)
+            newest[log[i].row.roll] = i;
+        for (size_t i = first; i < log.size(); ++i)
+            if (newest[log[i].row.roll] == i)
+                out.push_back(log[i]);
+        return true;
+    }
+
+private:
+    deque<RowChange> log;
+
+    void append(RowChange::Kind kind, const Student &s)
+    {
+        if (log.size() == CAPACITY)
+            log.pop_front();
+        RowChange c;
+        c.seq = ++lastSeq;
+        c.kind = kind;
+        c.row = s;
+        log.push_back(move(c));
+    }
+};
+
+class StudentManager
+{
+public:
+    vector<Student> students;
+    SortState sortState;
+
+    // Bitmap indexes over positions in `students`
+    FieldIndex departmentIndex;
+    FieldIndex gradeIndex;
+
+    // Numeric columns mirrored from `students` for query scans
+    vector<float> cgpaColumn;
+    vector<int> rollColumn;
+
+    // Roll -> the row holding it; rolls are unique within a roster
+    unordered_map<int, uint32_t> rollIndex;
+
+    // Live per-department and per-grade statistics
+    RosterAggregates aggregates;
+
+    // CGPA rank and percentile queries, overall and per department
+    RankIndex ranks;
+
+    // Top-N by CGPA per department
+    Leaderboard leaderboard;
+
+    // Bumped on every mutation so views can tell when to refresh
+    uint64_t version = 0;
+
+    // Row-level deltas for subscribers that apply changes instead of reloading
+    ChangeFeed changes;
+
+    // Returns false, adding nothing, when the roll is already taken
+    bool add(const Student &s)
+    {
+        if (rollIndex.count(s.roll))
+            return false;
+        students.push_back(s);
+        indexRow((uint32_t)students.size() - 1);
+        changes.upsert(s);
+        ++version;
+        return true;
+    }
+    // Replace a student's fields in place, keeping the indexes in sync.
+    // Returns false, changing nothing, when the new roll belongs to another row.
+    bool update(Student *s, const Student &values)
+    {
+        if (values.roll != s->roll && rollIndex.count(values.roll))
+            return false;
+        uint32_t row = (uint32_t)(s - students.data());
+        unindexRow(row);
+        int oldRoll = s->roll;
+        *s = values;
+        indexRow(row);
+        // No other row holds the old roll, so subscribers can drop it
+        if (oldRoll != values.roll)
+            changes.removed(oldRoll);
+        changes.upsert(values);
+        ++version;
+        return true;
+    }
+    void removeByRoll(int roll)
+    {
+        TRACE_SPAN("removeByRoll");
+        auto found = rollIndex.find(roll);
+        if (found == rollIndex.end())
+            return;
+        uint32_t row = found->second;
+        unindexValues(students[row]);
+        // Erasing shifts every later row, so positions are re-indexed
+        students.erase(students.begin() + row);
+        reindexPositions(row);
+        changes.removed(roll);
+        ++version;
+    }
+    // Remove every student whose roll is listed, re-indexing once; returns
+    // how many rows went
+    size_t removeRolls(vector<int> rolls)
+    {
+        TRACE_SPAN("removeRolls");
+        sort(rolls.begin(), rolls.end());
+        vector<int> gone; // the tail remove_if leaves behind is unspecified
+        uint32_t from = (uint32_t)students.size();
+        auto it = remove_if(students.begin(), students.end(),
+                            [&](const Student &s)
+                            {
+                                bool hit = binary_search(rolls.begin(), rolls.end(), s.roll);
+                                if (hit)
+                                {
+                                    from = min(from, (uint32_t)(&s - students.data()));
+                                    gone.push_back(s.roll);
+                                    unindexValues(s);
+                                }
+                                return hit;
+                            });
+        size_t removed = gone.size();
+        if (removed == 0)
+            return 0;
+        for (int roll : gone)
+            changes.removed(roll);
+        students.erase(it, students.end());
+        reindexPositions(from);
+        ++version;
+        return removed;
+    }
+    Student *findByRoll(int roll)
+    {
+        auto it = rollIndex.find(roll);
+        return it == rollIndex.end() ? nullptr : &students[it->second];
+    }
+    vector<Student *> search(const string &q);
+
+    // Departments are ORed together, grades are ORed together, and the two
+    // groups are ANDed. An empty list leaves that field unconstrained. The
+    // name/roll search is only applied to rows that survive the bitmaps.
+    vector<Student *> filter(const vector<string> &departments, const vector<string> &grades, const string &q = "");
+
+    // Run a search box query (see QueryParser). Index-backed terms are
+    // resolved to a bitmap first; the rest filter a selection vector of row
+    // positions in batches. An empty query returns every student.
+    vector<Student *> query(const string &text, QueryPlan *plan = nullptr);
+
+    // Clicking the same column again flips the direction
+    void sortBy(SortColumn column);
+    void sortBy(SortColumn column, bool ascending);
+
+    // Top-N per department, best first; O(departments x N) when nothing is dirty
+    vector<pair<string, vector<Leaderboard::Entry>>> leaderboards();
+
+    // One line per leaderboard entry: department, rank, name, roll, cgpa
+    void exportLeaderboards(const string &fname = "leaderboard.txt");
+
+    // Replace the whole roster and rebuild the indexes once. A row repeating
+    // an earlier row's roll is dropped, as it is by load().
+    void assign(vector<Student> rows)
+    {
+        students = move(rows);
+        rebuildIndexes();
+        changes.reset();
+        ++version;
+    }
+
+    void save(const string &fname = "students.txt");
+    void load(const string &fname = "students.txt");
+
+private:
+    static constexpr size_t SCAN_BATCH = 1024;
+
+    // Case-insensitive substring test without copying the haystack
+    static bool containsLower(const string &hay, const string &lowerNeedle)
+    {
+        if (lowerNeedle.empty())
+            return true;
+        if (hay.size() < lowerNeedle.size())
+            return false;
+        for (size_t i = 0; i + lowerNeedle.size() <= hay.size(); ++i)
+        {
+            size_t j = 0;
+            while (j < lowerNeedle.size() && tolower((unsigned char)hay[i + j]) == lowerNeedle[j])
+                ++j;
+            if (j == lowerNeedle.size())
+                return true;
+        }
+        return false;
+    }
+
+    static bool matchesSearch(const Student &s, const string &lowerq)
+    {
+        if (containsLower(s.name, lowerq))
+            return true;
+        char sroll[16];
+        *to_chars(sroll, sroll + sizeof(sroll) - 1, s.roll).ptr = '\0';
+        return strstr(sroll, lowerq.c_str()) != nullptr;
+    }
+
+    string describePlan(const QueryNode &n) const;
+
+    RoaringBitmap bitmapFor(const QueryNode &n) const;
+
+    // Keep the rows of a batch for which pred holds, compacting in place
+    template <typename Pred>
+    static size_t compact(uint32_t *rows, size_t k, Pred pred)
+    {
+        size_t n = 0;
+        for (size_t i = 0; i < k; ++i)
+        {
+            uint32_t row = rows[i];
+            rows[n] = row;
+            n += pred(row) ? 1 : 0;
+        }
+        return n;
+    }
+
+    template <typename T>
+    static size_t compare(const T *col, QueryNode::Op op, T lo, T hi, uint32_t *rows, size_t k)
+    {
+        switch (op)
+        {
+        case QueryNode::EQ:
+            return compact(rows, k, [col, lo, hi](uint32_t r)
+                           { return col[r] >= lo && col[r] <= hi; });
+        case QueryNode::LT:
+            return compact(rows, k, [col, lo](uint32_t r)
+                           { return col[r] < lo; });
+        case QueryNode::LE:
+            return compact(rows, k, [col, hi](uint32_t r)
+                           { return col[r] <= hi; });
+        case QueryNode::GT:
+            return compact(rows, k, [col, hi](uint32_t r)
+                           { return col[r] > hi; });
+        default:
+            return compact(rows, k, [col, lo](uint32_t r)
+                           { return col[r] >= lo; });
+        }
+    }
+
+    // Resolve every index-backed subtree to its bitmap once, before scanning
+    void resolveIndexes(QueryNode &n) const;
+
+    // Filter one sorted batch of row positions by n; returns the new length
+    size_t filterBatch(const QueryNode &n, uint32_t *rows, size_t k) const;
+
+    void indexRow(uint32_t row)
+    {
+        indexFields(row);
+        aggregates.insert(students[row]);
+        ranks.insert(students[row]);
+        leaderboard.insert(students[row]);
+    }
+
+    void indexFields(uint32_t row)
+    {
+        const Student &s = students[row];
+        departmentIndex.insert(s.department, row);
+        gradeIndex.insert(s.grade, row);
+        rollIndex[s.roll] = row;
+        if (row == cgpaColumn.size())
+        {
+            cgpaColumn.push_back(s.cgpa);
+            rollColumn.push_back(s.roll);
+        }
+        else
+        {
+            cgpaColumn[row] = s.cgpa;
+            rollColumn[row] = s.roll;
+        }
+    }
+
+    void unindexRow(uint32_t row)
+    {
+        const Student &s = students[row];
+        departmentIndex.erase(s.department, row);
+        gradeIndex.erase(s.grade, row);
+        rollIndex.erase(s.roll);
+        aggregates.erase(s);
+        ranks.erase(s);
+        leaderboard.erase(s);
+    }
+
+    // Take a row that is about to be deleted out of the order-independent
+    // structures; reindexPositions() then deals with the shifted positions
+    void unindexValues(const Student &s)
+    {
+        rollIndex.erase(s.roll);
+        aggregates.erase(s);
+        ranks.erase(s);
+        leaderboard.erase(s);
+    }
+
+    // Bitmaps, columns and roll index after the rows from `from` on moved
+    // (a delete or a sort)
+    void reindexPositions(uint32_t from = 0);
+
+    // Everything, after the roster was replaced; drops repeated rolls first
+    void rebuildIndexes();
+};
@@ -0,0 +1,169 @@
+// trace.h
+// Chrome trace-event recording. Each thread appends complete ("X") events to
+// its own chunked buffer without taking a lock; Trace::writeJson snapshots
+// every buffer into a file chrome://tracing and Perfetto can open.
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdint>
+using namespace std;
+
+class TraceEvent
+{
+public:
+    const char *name; // must outlive the trace (string literals)
+    const char *category;
+    int64_t startNs;
+    int64_t durationNs;
+};
+
+// Single-writer event log. Only the owning thread appends; readers see a
+// chunk's events up to its published count.
+class TraceBuffer
+{
+public:
+    static constexpr size_t CHUNK_EVENTS = 16384;
+
+    class Chunk
+    {
+    public:
+        TraceEvent events[CHUNK_EVENTS];
+        atomic<size_t> count{0};
+        atomic<Chunk *> next{nullptr};
+    };
+
+    uint32_t threadId = 0;
+    Chunk head;
+
+    void push(const TraceEvent &e)
+    {
+        size_t n = tail->count.load(memory_order_relaxed);
+        if (n == CHUNK_EVENTS)
+        {
+            Chunk *c = new Chunk;
+            tail->next.store(c, memory_order_release);
+            tail = c;
+            n = 0;
+        }
+        tail->events[n] = e;
+        tail->count.store(n + 1, memory_order_release);
+    }
+
+private:
+    Chunk *tail = &head;
+};
+
+class Trace
+{
+public:
+    // The only check a disabled span performs
+    static bool on() { return enabled.load(memory_order_relaxed); }
+
+    static void setEnabled(bool value) { enabled.store(value, memory_order_relaxed); }
+
+    static int64_t toNs(chrono::steady_clock::time_point t)
+    {
+        return chrono::duration_cast<chrono::nanoseconds>(t - epoch).count();
+    }
+
+    static int64_t nowNs() { return toNs(chrono::steady_clock::now()); }
+
+    static void record(const char *name, const char *category, int64_t startNs, int64_t endNs)
+    {
+        local().push({name, category, startNs, endNs - startNs});
+    }
+
+    static size_t eventCount()
+    {
+        size_t total = 0;
+        forEachEvent([&](uint32_t, const TraceEvent &)
+                     { ++total; });
+        return total;
+    }
+
+    // Write everything recorded so far in Trace Event Format; buffers are
+    // kept, so later calls write a superset
+    static bool writeJson(const string &path)
+    {
+        ofstream f(path);
+        if (!f.is_open())
+            return false;
+        f << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        bool first = true;
+        char line[256];
+        forEachEvent([&](uint32_t tid, const TraceEvent &e)
+                     {
+                         snprintf(line, sizeof(line),
+                                  "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+                                  first ? "" : ",\n", e.name, e.category, e.startNs / 1000.0, e.durationNs / 1000.0, tid);
+                         f << line;
+                         first = false; });
+        f << "\n]}\n";
+        return true;
+    }
+
+private:
+    static inline atomic<bool> enabled{false};
+    static inline const chrono::steady_clock::time_point epoch = chrono::steady_clock::now();
+    static inline mutex registryMutex;
+    static inline vector<TraceBuffer *> buffers; // never freed so exited threads keep their events
+
+    static TraceBuffer &local()
+    {
+        thread_local TraceBuffer *buffer = registerThread();
+        return *buffer;
+    }
+
+    static TraceBuffer *registerThread()
+    {
+        TraceBuffer *b = new TraceBuffer;
+        lock_guard<mutex> lock(registryMutex);
+        b->threadId = (uint32_t)buffers.size() + 1;
+        buffers.push_back(b);
+        return b;
+    }
+
+    template <typename F>
+    static void forEachEvent(F f)
+    {
+        lock_guard<mutex> lock(registryMutex);
+        for (TraceBuffer *b : buffers)
+            for (TraceBuffer::Chunk *c = &b->head; c; c = c->next.load(memory_order_acquire))
+            {
+                size_t n = c->count.load(memory_order_acquire);
+                for (size_t i = 0; i < n; ++i)
+                    f(b->threadId, c->events[i]);
+            }
+    }
+};
+
+// Records the lifetime of a scope when tracing is on
+class TraceSpan
+{
+public:
+    TraceSpan(const char *name, const char *category = "roster") : name(name), category(category), active(Trace::on())
+    {
+        if (active)
+            start = Trace::nowNs();
+    }
+
+    ~TraceSpan()
+    {
+        if (active)
+            Trace::record(name, category, start, Trace::nowNs());
+    }
+
+private:
+    const char *name;
+    const char *category;
+    bool active;
+    int64_t start = 0;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SPAN(name) TraceSpan TRACE_CONCAT(traceSpan, __LINE__)(name)
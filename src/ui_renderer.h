@@ -0,0 +1,670 @@
+// ui_renderer.h
+// OpenGL 3.3 core renderer for the hand-drawn GUI. Rectangles, outlines and
+// text quads are appended to one vertex array as coloured triangles, and
+// flush() uploads it to a single VBO and draws it with one shader program.
+// A frame goes out in one draw call, in the order it was built, so blending
+// works the same as it did with immediate mode. Coordinates are logical pixels
+// with the origin at the bottom left, like the old glOrtho(0, W, 0, H)
+// projection; on a HiDPI display each one covers `scale` framebuffer pixels.
+// Caches, clips and the backing store work in framebuffer pixels.
+//
+// Content that rarely changes but moves often (the student list) lives in a
+// RectInstances layer instead: its rectangles stay in their own buffer and
+// are drawn instanced, so moving the layer only changes a uniform. A
+// RegionCache goes one step further and keeps the drawn pixels of a region in
+// a texture, so a frame where the region did not change only copies them.
+//
+// The whole window is drawn into a BackingStore. Each frame only the areas in
+// a DamageRegion are cleared and drawn again, under a scissor, and the store is
+// then copied to the window; a frame where nothing changed is just the copy.
+#pragma once
+#include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+using namespace std;
+
+// Axis-aligned rectangles kept on the GPU between frames. Fill `instances`,
+// upload() once, then draw it with UiRenderer::drawInstances as often as needed.
+class RectInstances
+{
+public:
+    struct Instance
+    {
+        float x, y, w, h; // relative to the offset the layer is drawn at
+        uint32_t color;
+    };
+
+    vector<Instance> instances;
+    uint64_t uploads = 0; // times the GPU copy was rewritten
+
+    void upload()
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(instances.size() * sizeof(Instance)), instances.data(), GL_STATIC_DRAW);
+        uploadedCount = instances.size();
+        ++uploads;
+    }
+
+private:
+    friend class UiRenderer;
+    GLuint vao = 0, vbo = 0;
+    size_t uploadedCount = 0;
+};
+
+// A screen region rendered to a texture and copied to the window when needed.
+// There are two targets: on a scroll the still-valid pixels are blitted from
+// one into the other, shifted, and only the exposed strip is drawn again.
+class RegionCache
+{
+public:
+    int width = 0, height = 0; // pixels
+    bool valid = false;
+    int scroll = 0; // content scroll the cached pixels were drawn at
+
+    // How each frame was served
+    uint64_t fullRedraws = 0;
+    uint64_t stripRedraws = 0;
+    uint64_t reuses = 0;
+
+private:
+    friend class UiRenderer;
+    GLuint fbo[2] = {}, texture[2] = {};
+    int current = 0; // target holding the valid pixels
+};
+
+// The window's pixels, kept between frames so only changed areas are redrawn
+class BackingStore
+{
+public:
+    int width = 0, height = 0; // pixels
+    bool valid = false;        // false until every pixel has been drawn once
+
+private:
+    friend class UiRenderer;
+    GLuint fbo = 0, texture = 0;
+    GLint window = 0; // framebuffer to present to, as bound at beginBacking()
+};
+
+// Window areas to draw again this frame, in whole framebuffer pixels. A few separate
+// rectangles are kept so that, say, a button press and a list scroll do not
+// merge into one rectangle covering both; overlapping ones are combined, and
+// past MAX_RECTS the newest is folded into another.
+class DamageRegion
+{
+public:
+    struct Rect
+    {
+        int x0, y0, x1, y1; // [x0, x1) x [y0, y1)
+    };
+    static constexpr int MAX_RECTS = 4;
+
+    Rect rects[MAX_RECTS];
+    int count = 0;
+
+    float scale = 1.0f; // framebuffer pixels per unit of add()'s coordinates
+
+    // The frame before the last clear(), for the F3 overlay
+    int lastCount = 0;
+    long long lastPixels = 0;
+
+    bool empty() const { return count == 0; }
+
+    void clear()
+    {
+        lastCount = count;
+        lastPixels = 0;
+        for (int i = 0; i < count; ++i)
+            lastPixels += (long long)(rects[i].x1 - rects[i].x0) * (rects[i].y1 - rects[i].y0);
+        count = 0;
+    }
+
+    // A rectangle in logical pixels, rounded outwards so every framebuffer
+    // pixel it touches is included
+    void add(float x, float y, float w, float h)
+    {
+        if (w <= 0 || h <= 0)
+            return;
+        Rect r = {(int)floor(x * scale), (int)floor(y * scale), (int)ceil((x + w) * scale), (int)ceil((y + h) * scale)};
+        for (;;)
+        {
+            int i = 0;
+            while (i < count && !overlaps(r, rects[i]))
+                ++i;
+            if (i == count && count < MAX_RECTS)
+                break;
+            if (i == count)
+                i = count - 1;
+            r = {min(r.x0, rects[i].x0), min(r.y0, rects[i].y0), max(r.x1, rects[i].x1), max(r.y1, rects[i].y1)};
+            rects[i] = rects[--count];
+        }
+        rects[count++] = r;
+    }
+
+private:
+    static bool overlaps(const Rect &a, const Rect &b)
+    {
+        return a.x0 <= b.x1 && b.x0 <= a.x1 && a.y0 <= b.y1 && b.y0 <= a.y1;
+    }
+};
+
+class UiRenderer
+{
+public:
+    struct Vertex
+    {
+        float x, y;
+        uint32_t color; // RGBA8, red in the lowest byte
+    };
+
+    string error;
+    float width = 0, height = 0; // projection size in logical pixels
+    float scale = 1.0f;          // framebuffer pixels per logical pixel
+
+    // The frame being built; endFrame() moves them to the last* counters
+    int drawCalls = 0;
+    size_t vertexCount = 0;
+    size_t instanceCount = 0;
+
+    // Last finished frame, for the F3 overlay
+    int lastDrawCalls = 0;
+    size_t lastVertexCount = 0;
+    size_t lastInstanceCount = 0;
+
+    bool init()
+    {
+        static const char *vertexSource =
+            "#version 330 core\n"
+            "layout(location = 0) in vec2 aPos;\n"
+            "layout(location = 1) in vec4 aColor;\n"
+            "uniform mat4 uProjection;\n"
+            "out vec4 vColor;\n"
+            "void main()\n"
+            "{\n"
+            "    vColor = aColor;\n"
+            "    gl_Position = uProjection * vec4(aPos, 0.0, 1.0);\n"
+            "}\n";
+        // A unit quad stretched over each instance's rectangle
+        static const char *instanceSource =
+            "#version 330 core\n"
+            "layout(location = 0) in vec2 aCorner;\n"
+            "layout(location = 1) in vec4 aRect;\n"
+            "layout(location = 2) in vec4 aColor;\n"
+            "uniform mat4 uProjection;\n"
+            "uniform vec2 uOffset;\n"
+            "out vec4 vColor;\n"
+            "void main()\n"
+            "{\n"
+            "    vColor = aColor;\n"
+            "    gl_Position = uProjection * vec4(aRect.xy + aCorner * aRect.zw + uOffset, 0.0, 1.0);\n"
+            "}\n";
+        static const char *fragmentSource =
+            "#version 330 core\n"
+            "in vec4 vColor;\n"
+            "out vec4 fragColor;\n"
+            "void main()\n"
+            "{\n"
+            "    fragColor = vColor;\n"
+            "}\n";
+
+        program = link(vertexSource, fragmentSource);
+        instanceProgram = program ? link(instanceSource, fragmentSource) : 0;
+        if (!instanceProgram)
+            return false;
+        projectionLoc = glGetUniformLocation(program, "uProjection");
+        instanceProjectionLoc = glGetUniformLocation(instanceProgram, "uProjection");
+        offsetLoc = glGetUniformLocation(instanceProgram, "uOffset");
+
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &vbo);
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, x));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), (void *)offsetof(Vertex, color));
+        glBindVertexArray(0);
+
+        const float corners[8] = {0, 0, 1, 0, 0, 1, 1, 1};
+        glGenBuffers(1, &cornerVbo);
+        glBindBuffer(GL_ARRAY_BUFFER, cornerVbo);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+
+        vertices.reserve(64 * 1024);
+        return true;
+    }
+
+    void shutdown()
+    {
+        glDeleteBuffers(1, &vbo);
+        glDeleteBuffers(1, &cornerVbo);
+        glDeleteVertexArrays(1, &vao);
+        glDeleteProgram(program);
+        glDeleteProgram(instanceProgram);
+        vbo = cornerVbo = vao = program = instanceProgram = 0;
+    }
+
+    // GPU objects for a layer; call once before its first upload()
+    void createInstances(RectInstances &layer)
+    {
+        glGenVertexArrays(1, &layer.vao);
+        glGenBuffers(1, &layer.vbo);
+        glBindVertexArray(layer.vao);
+        glBindBuffer(GL_ARRAY_BUFFER, cornerVbo);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void *)0);
+        glBindBuffer(GL_ARRAY_BUFFER, layer.vbo);
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(RectInstances::Instance), (void *)0);
+        glVertexAttribDivisor(1, 1);
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(RectInstances::Instance),
+                              (void *)offsetof(RectInstances::Instance, color));
+        glVertexAttribDivisor(2, 1);
+        glBindVertexArray(0);
+    }
+
+    void destroyInstances(RectInstances &layer)
+    {
+        glDeleteBuffers(1, &layer.vbo);
+        glDeleteVertexArrays(1, &layer.vao);
+        layer.vbo = layer.vao = 0;
+        layer.uploadedCount = 0;
+    }
+
+    // Draw a layer shifted by (dx, dy), clipped to the given rectangle in
+    // framebuffer pixels and to setClip()'s. What the batch holds so far goes
+    // first, so the layer lands on top of it.
+    void drawInstances(const RectInstances &layer, float dx, float dy, int clipX, int clipY, int clipW, int clipH)
+    {
+        flush();
+        if (layer.uploadedCount == 0)
+            return;
+        int x0 = clipX, y0 = clipY, x1 = x0 + clipW, y1 = y0 + clipH;
+        if (clipping)
+        {
+            x0 = max(x0, clip[0]);
+            y0 = max(y0, clip[1]);
+            x1 = min(x1, clip[0] + clip[2]);
+            y1 = min(y1, clip[1] + clip[3]);
+        }
+        glEnable(GL_SCISSOR_TEST);
+        glScissor(x0 - targetX, y0 - targetY, max(0, x1 - x0), max(0, y1 - y0));
+        glUseProgram(instanceProgram);
+        glUniform2f(offsetLoc, dx, dy);
+        glBindVertexArray(layer.vao);
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)layer.uploadedCount);
+        glBindVertexArray(0);
+        applyClip();
+        ++drawCalls;
+        instanceCount += layer.uploadedCount;
+    }
+
+    // Orthographic projection over a w x h logical space, y up, drawn at
+    // `pixelScale` framebuffer pixels per logical pixel
+    void setProjection(float w, float h, float pixelScale = 1.0f)
+    {
+        width = w;
+        height = h;
+        scale = pixelScale;
+        applyProjection(0, 0, w, h);
+    }
+
+    // The framebuffer pixel a logical coordinate falls on
+    int toPixels(float v) const { return (int)floor(v * scale + 0.5f); }
+
+    // Targets for a w x h framebuffer pixel region; a size change drops the
+    // cached pixels
+    void resizeCache(RegionCache &cache, int w, int h)
+    {
+        if (cache.fbo[0] && cache.width == w && cache.height == h)
+            return;
+        destroyCache(cache);
+        cache.width = w;
+        cache.height = h;
+        glGenFramebuffers(2, cache.fbo);
+        glGenTextures(2, cache.texture);
+        GLint previous = 0;
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previous);
+        for (int i = 0; i < 2; ++i)
+        {
+            glBindTexture(GL_TEXTURE_2D, cache.texture[i]);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glBindFramebuffer(GL_FRAMEBUFFER, cache.fbo[i]);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, cache.texture[i], 0);
+        }
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glBindFramebuffer(GL_FRAMEBUFFER, previous);
+    }
+
+    void destroyCache(RegionCache &cache)
+    {
+        glDeleteFramebuffers(2, cache.fbo);
+        glDeleteTextures(2, cache.texture);
+        cache.fbo[0] = cache.fbo[1] = cache.texture[0] = cache.texture[1] = 0;
+        cache.valid = false;
+    }
+
+    // Draw `layer` at (0, dy) into `cache`, which stands for the region of its
+    // size at logical (x, y). `scroll` is the content offset in whole
+    // framebuffer pixels, growing as the content moves up. If only it changed since the last call, the cached
+    // pixels are shifted and only the exposed strip is drawn; `changed` redraws
+    // everything. Returns whether the cached pixels changed; drawCache() then
+    // copies them to the window.
+    bool updateCache(RegionCache &cache, const RectInstances &layer, float dy, int scroll, bool changed, float x, float y,
+                     float r, float g, float b)
+    {
+        flush();
+        int w = cache.width, h = cache.height;
+        int shift = scroll - cache.scroll;
+        GLint window = 0, viewport[4];
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &window);
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        // The clip is in window coordinates; the cache is drawn without it
+        bool windowClipping = clipping;
+        clipping = false;
+        applyClip();
+        bool redrawn = true;
+
+        if (!cache.valid || changed || shift >= h || -shift >= h)
+        {
+            beginTarget(cache.fbo[cache.current], x, y, w, h);
+            glClearColor(r, g, b, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+            drawInstances(layer, 0, dy, targetX, targetY, w, h);
+            ++cache.fullRedraws;
+        }
+        else if (shift != 0)
+        {
+            // Content moving up by `shift` exposes a strip at the bottom;
+            // moving down exposes one at the top
+            int next = 1 - cache.current;
+            int keep = h - (shift > 0 ? shift : -shift);
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, cache.fbo[cache.current]);
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, cache.fbo[next]);
+            if (shift > 0)
+                glBlitFramebuffer(0, 0, w, keep, 0, shift, w, h, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+            else
+                glBlitFramebuffer(0, -shift, w, h, 0, 0, w, keep, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+            cache.current = next;
+
+            int stripY = shift > 0 ? 0 : keep;
+            beginTarget(cache.fbo[cache.current], x, y, w, h);
+            glEnable(GL_SCISSOR_TEST);
+            glScissor(0, stripY, w, h - keep);
+            glClearColor(r, g, b, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+            glDisable(GL_SCISSOR_TEST);
+            drawInstances(layer, 0, dy, targetX, targetY + stripY, w, h - keep);
+            ++cache.stripRedraws;
+        }
+        else
+        {
+            ++cache.reuses;
+            redrawn = false;
+        }
+        cache.valid = true;
+        cache.scroll = scroll;
+
+        // Back to the window as it was
+        targetX = targetY = 0;
+        glBindFramebuffer(GL_FRAMEBUFFER, window);
+        glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+        applyProjection(0, 0, width, height);
+        clipping = windowClipping;
+        applyClip();
+        return redrawn;
+    }
+
+    // Copy the cached pixels to logical (x, y) in the bound target, inside
+    // the clip
+    void drawCache(const RegionCache &cache, float x, float y)
+    {
+        flush();
+        GLint target = 0, px = toPixels(x), py = toPixels(y);
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &target);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, cache.fbo[cache.current]);
+        glBlitFramebuffer(0, 0, cache.width, cache.height, px, py, px + cache.width, py + cache.height,
+                          GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        glBindFramebuffer(GL_FRAMEBUFFER, target);
+        ++drawCalls;
+    }
+
+    // A store the size of the framebuffer; a size change drops its pixels
+    void resizeBacking(BackingStore &store, int w, int h)
+    {
+        if (store.fbo && store.width == w && store.height == h)
+            return;
+        destroyBacking(store);
+        store.width = w;
+        store.height = h;
+        glGenFramebuffers(1, &store.fbo);
+        glGenTextures(1, &store.texture);
+        GLint previous = 0;
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previous);
+        glBindTexture(GL_TEXTURE_2D, store.texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glBindFramebuffer(GL_FRAMEBUFFER, store.fbo);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, store.texture, 0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glBindFramebuffer(GL_FRAMEBUFFER, previous);
+    }
+
+    void destroyBacking(BackingStore &store)
+    {
+        glDeleteFramebuffers(1, &store.fbo);
+        glDeleteTextures(1, &store.texture);
+        store.fbo = store.texture = 0;
+        store.valid = false;
+    }
+
+    // Draw into the store instead of the window until presentBacking()
+    void beginBacking(BackingStore &store)
+    {
+        flush();
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &store.window);
+        glBindFramebuffer(GL_FRAMEBUFFER, store.fbo);
+    }
+
+    // Copy the whole store to the window; the store must have been fully
+    // drawn, so the first frame after a resize has to damage everything
+    void presentBacking(BackingStore &store)
+    {
+        clearClip();
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, store.fbo);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, store.window);
+        glBlitFramebuffer(0, 0, store.width, store.height, 0, 0, store.width, store.height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        glBindFramebuffer(GL_FRAMEBUFFER, store.window);
+        store.valid = true;
+        ++drawCalls;
+    }
+
+    // Limit drawing to a rectangle of framebuffer pixels until clearClip().
+    // The batch so far is flushed first, under the clip it was built for.
+    void setClip(int x, int y, int w, int h)
+    {
+        flush();
+        clip[0] = x;
+        clip[1] = y;
+        clip[2] = w;
+        clip[3] = h;
+        clipping = true;
+        applyClip();
+    }
+
+    void clearClip()
+    {
+        flush();
+        clipping = false;
+        applyClip();
+    }
+
+    // Whether a logical rectangle reaches into the clip; drawing that does
+    // not can be skipped
+    bool clipTouches(float x, float y, float w, float h) const
+    {
+        x *= scale;
+        y *= scale;
+        w *= scale;
+        h *= scale;
+        return !clipping || (x < clip[0] + clip[2] && x + w > clip[0] && y < clip[1] + clip[3] && y + h > clip[1]);
+    }
+
+    static uint32_t packColor(float r, float g, float b, float a)
+    {
+        auto channel = [](float v) { return (uint32_t)(v <= 0.0f ? 0 : v >= 1.0f ? 255 : v * 255.0f + 0.5f); };
+        return channel(r) | channel(g) << 8 | channel(b) << 16 | channel(a) << 24;
+    }
+
+    // Corners in order around the quad, as glBegin(GL_QUADS) took them
+    void quad(float x0, float y0, float x1, float y1, float x2, float y2, float x3, float y3, uint32_t color)
+    {
+        vertices.push_back({x0, y0, color});
+        vertices.push_back({x1, y1, color});
+        vertices.push_back({x2, y2, color});
+        vertices.push_back({x0, y0, color});
+        vertices.push_back({x2, y2, color});
+        vertices.push_back({x3, y3, color});
+    }
+
+    void rect(float x, float y, float w, float h, uint32_t color)
+    {
+        quad(x, y, x + w, y, x + w, y + h, x, y + h, color);
+    }
+
+    // One-pixel border on the pixels a GL_LINE_LOOP through the corners lit:
+    // columns x - 1 and x + w - 1, rows y - 1 and y + h - 1
+    void outline(float x, float y, float w, float h, uint32_t color)
+    {
+        rect(x - 1, y - 1, w + 1, 1, color);
+        rect(x - 1, y + h - 1, w + 1, 1, color);
+        rect(x - 1, y, 1, h - 1, color);
+        rect(x + w - 1, y, 1, h - 1, color);
+    }
+
+    // Draw everything appended since the last flush
+    void flush()
+    {
+        if (vertices.empty())
+            return;
+        glUseProgram(program);
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        // A fresh store each frame, so the driver never waits on last frame's draw
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(vertices.size() * sizeof(Vertex)), vertices.data(), GL_STREAM_DRAW);
+        glDrawArrays(GL_TRIANGLES, 0, (GLsizei)vertices.size());
+        glBindVertexArray(0);
+        ++drawCalls;
+        vertexCount += vertices.size();
+        vertices.clear(); // keeps its capacity: no allocation in later frames
+    }
+
+    // Flush the rest of the frame and roll the counters over
+    void endFrame()
+    {
+        flush();
+        lastDrawCalls = drawCalls;
+        lastVertexCount = vertexCount;
+        lastInstanceCount = instanceCount;
+        drawCalls = 0;
+        vertexCount = instanceCount = 0;
+    }
+
+private:
+    GLuint program = 0, vao = 0, vbo = 0;
+    GLuint instanceProgram = 0, cornerVbo = 0;
+    GLint projectionLoc = -1, instanceProjectionLoc = -1, offsetLoc = -1;
+    vector<Vertex> vertices;
+    int targetX = 0, targetY = 0; // where the bound target's pixel (0, 0) is in the window, in framebuffer pixels
+    bool clipping = false;
+    int clip[4] = {}; // x, y, w, h in framebuffer pixels
+
+    void applyClip()
+    {
+        if (!clipping)
+        {
+            glDisable(GL_SCISSOR_TEST);
+            return;
+        }
+        glEnable(GL_SCISSOR_TEST);
+        glScissor(clip[0], clip[1], clip[2], clip[3]);
+    }
+
+    void applyProjection(float left, float bottom, float w, float h)
+    {
+        const float m[16] = {2.0f / w, 0, 0, 0,
+                             0, 2.0f / h, 0, 0,
+                             0, 0, -1.0f, 0,
+                             -1.0f - 2.0f * left / w, -1.0f - 2.0f * bottom / h, 0, 1.0f};
+        glUseProgram(program);
+        glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, m);
+        glUseProgram(instanceProgram);
+        glUniformMatrix4fv(instanceProjectionLoc, 1, GL_FALSE, m);
+    }
+
+    // Render into `fbo` as if it were the w x h framebuffer pixel region at
+    // logical (x, y), snapped to a whole pixel
+    void beginTarget(GLuint fbo, float x, float y, int w, int h)
+    {
+        targetX = toPixels(x);
+        targetY = toPixels(y);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glViewport(0, 0, w, h);
+        applyProjection(targetX / scale, targetY / scale, w / scale, h / scale);
+    }
+
+    GLuint link(const char *vertexSource, const char *fragmentSource)
+    {
+        GLuint vs = compile(GL_VERTEX_SHADER, vertexSource);
+        GLuint fs = vs ? compile(GL_FRAGMENT_SHADER, fragmentSource) : 0;
+        if (!fs)
+        {
+            glDeleteShader(vs);
+            return 0;
+        }
+        GLuint linked = glCreateProgram();
+        glAttachShader(linked, vs);
+        glAttachShader(linked, fs);
+        glLinkProgram(linked);
+        glDeleteShader(vs);
+        glDeleteShader(fs);
+        GLint ok = 0;
+        glGetProgramiv(linked, GL_LINK_STATUS, &ok);
+        if (ok)
+            return linked;
+        error = "shader link failed: " + infoLog(linked, false);
+        glDeleteProgram(linked);
+        return 0;
+    }
+
+    GLuint compile(GLenum type, const char *source)
+    {
+        GLuint shader = glCreateShader(type);
+        glShaderSource(shader, 1, &source, nullptr);
+        glCompileShader(shader);
+        GLint ok = 0;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+        if (ok)
+            return shader;
+        error = string(type == GL_VERTEX_SHADER ? "vertex" : "fragment") + " shader: " + infoLog(shader, true);
+        glDeleteShader(shader);
+        return 0;
+    }
+
+    static string infoLog(GLuint object, bool isShader)
+    {
+        char log[1024] = "";
+        if (isShader)
+            glGetShaderInfoLog(object, sizeof(log), nullptr, log);
+        else
+            glGetProgramInfoLog(object, sizeof(log), nullptr, log);
+        return log;
+    }
+};